@@ -6,48 +6,328 @@
 
 #include "animation.h"
 
-#ifdef HAVE_ANIMATION
 #include <glib/gtimer.h>
+#include <string.h>
+#include <math.h>
+
+/* The part of a widget an animation changes, and so has to be redrawn */
+typedef enum {
+	DAMAGE_FACE,		/* the whole allocation, e.g. a button */
+	DAMAGE_FILL,		/* inside the style's thickness, e.g. a progress bar */
+	DAMAGE_INDICATOR	/* a check or radio indicator */
+} AnimationDamage;
+
+/* The animations live in parallel arrays indexed by slot; a widget finds
+ * its slot through qdata (stored as slot + 1).  Slots are kept dense: a
+ * finished animation is replaced by the last one. */
+typedef struct {
+	GtkWidget      **widget;
+	gdouble         *start_time;
+	gdouble         *start_modifier;
+	gdouble         *stop_time;
+	GtkStateType    *starting_state_type;
+	AnimationDamage *damage;
+	GdkRectangle    *indicator;	/* relative to the allocation */
+	gdouble         *redrawn;	/* frame time of the last redraw */
+	guint            n_slots;
+	guint            n_allocated;
+} AnimationSlots;
+
+/* How often the window a widget is in wants it redrawn */
+typedef enum {
+	TOPLEVEL_RUNNING,	/* focused, or a popup */
+	TOPLEVEL_SLOW,		/* not focused, at UNFOCUSED_ANIMATION_DELAY */
+	TOPLEVEL_PAUSED		/* fully obscured, minimized or hidden */
+} ToplevelRate;
+
+/* Flags kept as qdata on the toplevel windows of animated widgets */
+#define TOPLEVEL_WATCHED  (1 << 0)
+#define TOPLEVEL_OBSCURED (1 << 1)
+
+/* Widgets the animation code has connected to, used as a set.  All the
+ * handlers are connected with &connected_widgets as their data, so they
+ * can be found again without keeping their ids. */
+static GHashTable    *connected_widgets  = NULL;
+static AnimationSlots animations         = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0 };
+static EquinoxAnimationStats animation_stats;
+
+/* Damage collected during a tick, toplevel GdkWindow -> GdkRegion */
+static GHashTable    *pending_damage     = NULL;
+static GQuark         animation_quark    = 0;
+static GQuark         toplevel_quark     = 0;
+static GQuark         drawn_state_quark  = 0;
+static int            animation_timer_id = 0;
+static guint          animation_timer_interval = 0;	/* 0 while stopped */
+
+/* One clock for everything.  frame_time is read from it once per tick (and
+ * when an animation starts), so all widgets drawn for a tick agree on the
+ * time.  Progress bars also take their stripe phase from it, and are
+ * redrawn on the same ticks, so their stripes move in step. */
+static GTimer        *animation_clock    = NULL;
+static gdouble        frame_time         = 0.0;
+static guint          animation_tick     = 0;
+
+/* A virtual clock replaces animation_clock, and with it the main loop
+ * timer: equinox_animation_tick is then called for every tick. */
+static EquinoxAnimationClockFunc virtual_clock = NULL;
+static gpointer                  virtual_clock_data = NULL;
+
+/* Past the budget, animations snap to their end instead of queueing: a
+ * bulk change of hundreds of widgets would otherwise make every tick take
+ * longer than its period.  0 means no limit. */
+static guint          max_animations     = ANIMATION_LIMIT;
+static gdouble        tick_budget        = ANIMATION_BUDGET / 1000.0;	/* seconds */
+static GTimer        *tick_timer         = NULL;
+static gdouble        tick_work          = 0.0;	/* the last tick, without its repaints */
+
+/* How long the redraws of a tick take, smoothed, and the period that
+ * leaves the application enough time.  GDK repaints the damage from its
+ * idle after the tick; the expose handlers of the animated widgets time
+ * their own repaints into repaint_time, which the next tick picks up.
+ * Not adapted with a virtual clock, which would make replays depend on
+ * the machine. */
+static GTimer        *redraw_timer       = NULL;
+static gboolean       repaint_timing     = FALSE;	/* between an expose's two handlers */
+static gdouble        repaint_time       = 0.0;
+static gboolean       damage_flushed     = FALSE;	/* by the last tick */
+static gdouble        redraw_cost        = 0.0;
+static guint          frame_period       = ANIMATION_DELAY;
+static gboolean       slow_timer         = FALSE;	/* only unfocused windows left */
 
-struct _AnimationInfo {
-	GTimer *timer;
+static gboolean animation_timeout_handler (gpointer data);
 
-	gdouble start_modifier;
-	gdouble stop_time;
-	GtkWidget *widget;
-	GtkStateType starting_state_type;
-	gint update_delay;
-};
-typedef struct _AnimationInfo AnimationInfo;
+/* The rectangle the animation in a slot changes, in the coordinates of
+ * the widget's allocation */
+static void
+get_damage_area (guint slot, GdkRectangle *area)
+{
+	GtkWidget *widget = animations.widget[slot];
+	const GtkAllocation *allocation = &widget->allocation;
+
+	switch (animations.damage[slot]) {
+	case DAMAGE_FILL:
+		area->x = allocation->x + widget->style->xthickness;
+		area->y = allocation->y + widget->style->ythickness;
+		area->width = allocation->width - 2 * widget->style->xthickness;
+		area->height = allocation->height - 2 * widget->style->ythickness;
+		break;
+	case DAMAGE_INDICATOR:
+		*area = animations.indicator[slot];
+		area->x += allocation->x;
+		area->y += allocation->y;
+		break;
+	default:
+		area->x = allocation->x;
+		area->y = allocation->y;
+		area->width = allocation->width;
+		area->height = allocation->height;
+		break;
+	}
+}
 
-struct _SignalInfo {
-	GtkWidget *widget;
-	gulong handler_id;
-};
-typedef struct _SignalInfo SignalInfo;
+/* Adds the part of the widget that the animation changes to the damage of
+ * its toplevel window.  This never queues a resize, which would relayout
+ * the parent on every frame. */
+static void
+force_widget_redraw (guint slot)
+{
+	GtkWidget *widget = animations.widget[slot];
+	GdkWindow *window;
+	GdkRegion *region;
+	GdkRectangle area;
+	gint x, y;
 
-static GSList     *connected_widgets  = NULL;
-static GHashTable *animated_widgets   = NULL;
-static int         animation_timer_id = 0;
+	if (widget->window == NULL)
+		return;
 
-static gboolean animation_timeout_handler (gpointer data);
+	get_damage_area (slot, &area);
+	if (area.width <= 0 || area.height <= 0)
+		return;
+
+	animations.redrawn[slot] = frame_time;
+
+	/* the allocation is relative to the window the widget is drawn in,
+	 * which for widgets with a window of their own is the parent one */
+	window = GTK_WIDGET_NO_WINDOW (widget) ? widget->window : gdk_window_get_parent (widget->window);
+
+	while (window && window != gdk_window_get_toplevel (window)) {
+		gdk_window_get_position (window, &x, &y);
+		area.x += x;
+		area.y += y;
+		window = gdk_window_get_parent (window);
+	}
+
+	if (window == NULL)
+		return;
+
+	/* A progress bar repaints its pixmap only when it is marked dirty,
+	 * which a resize would do; with the invalidation alone its expose
+	 * copies the old stripes back. */
+	if (GTK_IS_PROGRESS_BAR (widget)) {
+		GTK_PROGRESS_BAR (widget)->dirty = TRUE;
+		animation_stats.dirtied_bars++;
+	}
+
+	if (pending_damage == NULL)
+		pending_damage = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) gdk_region_destroy);
+
+	region = g_hash_table_lookup (pending_damage, window);
+	if (region == NULL) {
+		g_hash_table_insert (pending_damage, window, gdk_region_rectangle (&area));
+	} else {
+		gdk_region_union_with_rect (region, &area);
+	}
+
+	animation_stats.damaged_widgets++;
+	animation_stats.pixels += area.width * area.height;
+	animation_stats.widget_pixels += widget->allocation.width * widget->allocation.height;
+}
 
-/* This forces a redraw on a widget */
 static void
-force_widget_redraw (GtkWidget *widget)
+invalidate_damage (gpointer window, gpointer region, gpointer data)
 {
-	if (GTK_IS_PROGRESS_BAR (widget))
-		gtk_widget_queue_resize (widget);
+	gdk_window_invalidate_region (window, region, TRUE);
+	animation_stats.invalidations++;
+}
+
+/* The redraws of a tick may take half its period, the other half is left
+ * to the application.  A display that cannot keep up gets fewer frames,
+ * each showing the animations where they should be by then. */
+static void
+update_frame_period (gdouble redraw_time)
+{
+	guint period;
+
+	if (redraw_cost == 0.0)
+		redraw_cost = redraw_time;
+	else
+		redraw_cost = 0.75 * redraw_cost + 0.25 * redraw_time;
+
+	period = ((guint) (2000.0 * redraw_cost) / ANIMATION_DELAY + 1) * ANIMATION_DELAY;
+	frame_period = CLAMP (period, ANIMATION_DELAY, MAX_ANIMATION_DELAY);
+}
+
+/* one invalidation per toplevel window for everything damaged this tick */
+static void
+flush_damage ()
+{
+	if (pending_damage == NULL || g_hash_table_size (pending_damage) == 0)
+		return;
+
+	g_hash_table_foreach (pending_damage, invalidate_damage, NULL);
+	g_hash_table_remove_all (pending_damage);
+	damage_flushed = TRUE;
+}
+
+/* The repaints of the damage the last tick flushed are done by now.
+ * Returns how long they took. */
+static gdouble
+fold_repaint_time ()
+{
+	gdouble elapsed = repaint_time;
+
+	if (damage_flushed) {
+		animation_stats.frames++;
+		if (virtual_clock == NULL)
+			update_frame_period (elapsed);
+	}
+
+	repaint_time = 0.0;
+	damage_flushed = FALSE;
+
+	return elapsed;
+}
+
+/* An animated widget is exposed.  Only the widget's own handlers run
+ * between these two, so the rest of the window, which is what the
+ * application repaints, is not counted.  A handler that stops the
+ * emission skips the second one, that repaint is then not counted. */
+static gboolean
+on_animated_expose (GtkWidget *widget, GdkEventExpose *event, gpointer data)
+{
+	if (redraw_timer == NULL)
+		redraw_timer = g_timer_new ();
+	g_timer_start (redraw_timer);
+	repaint_timing = TRUE;
+
+	return FALSE;
+}
+
+static gboolean
+on_animated_expose_after (GtkWidget *widget, GdkEventExpose *event, gpointer data)
+{
+	gdouble elapsed;
+
+	if (!repaint_timing)
+		return FALSE;
+
+	elapsed = g_timer_elapsed (redraw_timer, NULL);
+	repaint_time += elapsed;
+	animation_stats.redraw_time += elapsed;
+	repaint_timing = FALSE;
+
+	return FALSE;
+}
+
+/* Where GtkCheckButton puts its indicator, with some room around it as
+ * the engine draws indicators at a fixed 15 pixels. */
+static void
+get_indicator_area (GtkWidget *widget, GdkRectangle *area)
+{
+	gint size, spacing;
+
+	gtk_widget_style_get (widget, "indicator-size", &size, "indicator-spacing", &spacing, NULL);
+	size = MAX (size, 15);
+
+	area->x = gtk_container_get_border_width (GTK_CONTAINER (widget)) + spacing - 2;
+	area->y = (widget->allocation.height - size) / 2 - 2;
+	area->width = size + 4;
+	area->height = size + 4;
+
+	if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL)
+		area->x = widget->allocation.width - area->x - area->width;
+}
+
+/* samples the clock, which is started on first use */
+static gdouble
+update_frame_time ()
+{
+	if (virtual_clock != NULL) {
+		frame_time = virtual_clock (virtual_clock_data);
+		return frame_time;
+	}
+
+	if (animation_clock == NULL)
+		animation_clock = g_timer_new ();
+
+	frame_time = g_timer_elapsed (animation_clock, NULL);
+	return frame_time;
+}
+
+/* ensures that the timer is running at the given interval */
+static void
+set_timer (guint interval)
+{
+	if (animation_timer_interval == interval)
+		return;
+
+	if (animation_timer_id != 0)
+		g_source_remove (animation_timer_id);
+
+	/* a virtual clock is ticked by hand */
+	if (virtual_clock == NULL)
+		animation_timer_id = g_timeout_add (interval, animation_timeout_handler, NULL);
 	else
-		gtk_widget_queue_draw (widget);
+		animation_timer_id = 0;
+
+	animation_timer_interval = interval;
 }
 
-/* ensures that the timer is running */
+/* ensures that the timer is running at full rate */
 static void
 start_timer ()
 {
-	if (animation_timer_id == 0)
-		animation_timer_id = g_timeout_add (ANIMATION_DELAY, animation_timeout_handler, NULL);
+	set_timer (ANIMATION_DELAY);
 }
 
 /* ensures that the timer is stopped */
@@ -55,104 +335,334 @@ static void
 stop_timer ()
 {
 	if (animation_timer_id != 0)
-	{
 		g_source_remove(animation_timer_id);
-		animation_timer_id = 0;
-	}
+
+	animation_timer_id = 0;
+	animation_timer_interval = 0;
 }
 
+/* Nothing is drawn into a window that is minimized or fully covered, and
+ * a window the user is not working in does not need smooth animations.
+ * Whether a window is iconified or focused can be asked at any time, being
+ * obscured is only known from its visibility events. */
+static ToplevelRate
+get_toplevel_rate (GtkWidget *widget)
+{
+	GtkWidget *toplevel = gtk_widget_get_toplevel (widget);
+	guint flags;
 
-/* destroys an AnimationInfo structure including the GTimer */
-static void
-animation_info_destroy (AnimationInfo *animation_info)
+	if (!GTK_IS_WINDOW (toplevel) || toplevel->window == NULL)
+		return TOPLEVEL_RUNNING;
+
+	flags = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (toplevel), toplevel_quark));
+	if (flags & TOPLEVEL_OBSCURED)
+		return TOPLEVEL_PAUSED;
+
+	if (gdk_window_get_state (toplevel->window) & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN))
+		return TOPLEVEL_PAUSED;
+
+	/* popups (menus, tooltips) never get the focus */
+	if (GTK_WINDOW (toplevel)->type != GTK_WINDOW_POPUP && !gtk_window_is_active (GTK_WINDOW (toplevel)))
+		return TOPLEVEL_SLOW;
+
+	return TOPLEVEL_RUNNING;
+}
+
+/* Find the slot of the widget's animation, -1 if there is none */
+static gint
+lookup_animation_slot (const GtkWidget *widget)
 {
-	g_timer_destroy (animation_info->timer);
-	g_free (animation_info);
+	if (widget == NULL || animations.n_slots == 0)
+		return -1;
+
+	return GPOINTER_TO_INT (g_object_get_qdata (G_OBJECT (widget), animation_quark)) - 1;
 }
 
+static void on_animated_widget_destruction (gpointer data, GObject *object);
+static void watch_toplevel (GtkWidget *widget);
+
+/* Frees a slot by moving the last animation into it.  The widget's weak
+ * reference is dropped unless it is being destroyed already. */
+static void
+remove_animation_slot (guint slot, gboolean destroyed)
+{
+	GtkWidget *widget = animations.widget[slot];
+	guint last = animations.n_slots - 1;
+
+	if (!destroyed) {
+		g_object_set_qdata (G_OBJECT (widget), animation_quark, NULL);
+		g_object_weak_unref (G_OBJECT (widget), on_animated_widget_destruction, NULL);
+		g_signal_handlers_disconnect_matched (widget, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, &animations);
+	}
+
+	if (slot != last) {
+		animations.widget[slot] = animations.widget[last];
+		animations.start_time[slot] = animations.start_time[last];
+		animations.start_modifier[slot] = animations.start_modifier[last];
+		animations.stop_time[slot] = animations.stop_time[last];
+		animations.starting_state_type[slot] = animations.starting_state_type[last];
+		animations.damage[slot] = animations.damage[last];
+		animations.indicator[slot] = animations.indicator[last];
+		animations.redrawn[slot] = animations.redrawn[last];
+		g_object_set_qdata (G_OBJECT (animations.widget[slot]), animation_quark, GUINT_TO_POINTER (slot + 1));
+	}
+
+	animations.n_slots--;
+}
 
-/* This function does not unref the weak reference, because the object
- * is beeing destroyed currently. */
+/* The widget is being destroyed, its weak reference is gone already */
 static void
 on_animated_widget_destruction (gpointer data, GObject *object)
 {
-	/* steal the animation info from the hash table (destroying it would
-	 * result in the weak reference to be unrefed, which does not work
-	 * as the widget is already destroyed. */
-	g_hash_table_steal (animated_widgets, object);
-	animation_info_destroy ((AnimationInfo*) data);
+	gint slot = lookup_animation_slot ((GtkWidget*) object);
+
+	if (slot >= 0)
+		remove_animation_slot (slot, TRUE);
 }
 
-/* This function also needs to unref the weak reference. */
+/* Stops an animation.  This forces a last redraw, so that the widget is
+ * left in a sane state. */
 static void
-destroy_animation_info_and_weak_unref (gpointer data)
+stop_animation (guint slot)
+{
+	force_widget_redraw (slot);
+	remove_animation_slot (slot, FALSE);
+}
+
+/* How much it matters that a widget keeps animating: being under the
+ * pointer counts most, then having the focus, then being in the focused
+ * window.  Nobody sees a widget in a hidden window animate at all. */
+static guint
+get_animation_priority (GtkWidget *widget)
 {
-	AnimationInfo *animation_info = data;
+	ToplevelRate rate;
+	guint priority;
+
+	if (!GTK_WIDGET_DRAWABLE (widget))
+		return 0;
+
+	rate = get_toplevel_rate (widget);
+	if (rate == TOPLEVEL_PAUSED)
+		return 0;
 
-	/* force a last redraw. This is so that if the animation is removed,
-	 * the widget is left in a sane state. */
-	force_widget_redraw (animation_info->widget);
+	priority = rate == TOPLEVEL_RUNNING ? 2 : 1;
 
-	g_object_weak_unref (G_OBJECT (animation_info->widget), on_animated_widget_destruction, data);
-	animation_info_destroy (animation_info);
+	if (GTK_WIDGET_HAS_FOCUS (widget))
+		priority += 2;
+
+	/* asking for the pointer position would be a round trip to the X
+	 * server per widget, GTK knows which widget it is in */
+	if (GTK_WIDGET_STATE (widget) == GTK_STATE_PRELIGHT)
+		priority += 4;
+
+	return priority;
 }
 
-/* Find and return a pointer to the data linked to this widget, if it exists */
-static AnimationInfo*
-lookup_animation_info (const GtkWidget *widget)
+/* With all slots of the budget taken, the animation that matters least
+ * makes room for one that matters more.  Returns FALSE if the new one
+ * should snap instead; on a tie the running ones are left alone. */
+static gboolean
+make_room_for (GtkWidget *widget)
 {
-	if (animated_widgets)
-		return g_hash_table_lookup (animated_widgets, widget);
+	guint priority = get_animation_priority (widget);
+	guint lowest = G_MAXUINT;
+	guint slot, lowest_slot = 0;
+
+	for (slot = 0; slot < animations.n_slots && lowest > 0; slot++) {
+		guint p = get_animation_priority (animations.widget[slot]);
+
+		if (p < lowest) {
+			lowest = p;
+			lowest_slot = slot;
+		}
+	}
+
+	if (lowest >= priority)
+		return FALSE;
 
-	return NULL;
+	stop_animation (lowest_slot);
+	animation_stats.snapped++;
+	return TRUE;
 }
 
-/* Create all the relevant information for the animation, and insert it into the hash table. */
+static gint
+compare_priority (gconstpointer a, gconstpointer b, gpointer data)
+{
+	const guint *priority = data;
+
+	return (gint) priority[*(const guint*) a] - (gint) priority[*(const guint*) b];
+}
+
+/* The last tick and its repaints took tick_time, over the budget.  Keeps
+ * as many animations as would have fit at the same cost each, those that
+ * matter most, and snaps the others. */
 static void
-add_animation (const GtkWidget *widget, gdouble stop_time, GtkStateType prev_state, gint delay)
+shed_animations (gdouble tick_time)
 {
-	AnimationInfo *value;
+	guint keep = MAX (1, (guint) (animations.n_slots * tick_budget / tick_time));
+	guint n_shed, slot, i;
+	guint *priority, *order;
+	GtkWidget **shed;
 
-	/* object already in the list, do not add it twice */
-	if (lookup_animation_info (widget))
+	if (animations.n_slots <= keep)
 		return;
 
-	if (animated_widgets == NULL)
-		animated_widgets = g_hash_table_new_full (g_direct_hash, g_direct_equal,
-		                                          NULL, destroy_animation_info_and_weak_unref);
+	priority = g_new (guint, animations.n_slots);
+	order = g_new (guint, animations.n_slots);
+	for (slot = 0; slot < animations.n_slots; slot++) {
+		priority[slot] = get_animation_priority (animations.widget[slot]);
+		order[slot] = slot;
+	}
+	g_qsort_with_data (order, animations.n_slots, sizeof (guint), compare_priority, priority);
 
-	value = g_new(AnimationInfo, 1);
+	/* stopping an animation moves another one into its slot */
+	n_shed = animations.n_slots - keep;
+	shed = g_new (GtkWidget*, n_shed);
+	for (i = 0; i < n_shed; i++)
+		shed[i] = animations.widget[order[i]];
 
-	value->widget = (GtkWidget*) widget;
+	for (i = 0; i < n_shed; i++)
+		stop_animation (lookup_animation_slot (shed[i]));
+	animation_stats.snapped += n_shed;
 
-	value->timer = g_timer_new ();
-	value->stop_time= stop_time;
-	value->start_modifier = 0.0;
-	value->starting_state_type = prev_state;
-	value->update_delay = delay;
+	g_free (shed);
+	g_free (order);
+	g_free (priority);
+}
 
-	g_object_weak_ref (G_OBJECT (widget), on_animated_widget_destruction, value);
-	g_hash_table_insert (animated_widgets, (GtkWidget*) widget, value);
+static void
+grow_animation_slots ()
+{
+	guint n = MAX (16, animations.n_allocated * 2);
+
+	animations.widget = g_renew (GtkWidget*, animations.widget, n);
+	animations.start_time = g_renew (gdouble, animations.start_time, n);
+	animations.start_modifier = g_renew (gdouble, animations.start_modifier, n);
+	animations.stop_time = g_renew (gdouble, animations.stop_time, n);
+	animations.starting_state_type = g_renew (GtkStateType, animations.starting_state_type, n);
+	animations.damage = g_renew (AnimationDamage, animations.damage, n);
+	animations.indicator = g_renew (GdkRectangle, animations.indicator, n);
+	animations.redrawn = g_renew (gdouble, animations.redrawn, n);
+	animations.n_allocated = n;
+}
 
-	start_timer ();
+/* Create all the relevant information for the animation and give it a slot */
+static void
+add_animation (const GtkWidget *widget, gdouble stop_time, GtkStateType prev_state)
+{
+	guint slot;
 
+	/* object already animated, do not add it twice */
+	if (lookup_animation_slot (widget) >= 0)
+		return;
+
+	if (animation_quark == 0)
+		animation_quark = g_quark_from_static_string ("equinox-animation-slot");
+
+	/* drawn in its new state straight away */
+	if (max_animations > 0 && animations.n_slots >= max_animations && !make_room_for ((GtkWidget*) widget)) {
+		animation_stats.snapped++;
+		return;
+	}
+
+	if (animations.n_slots == animations.n_allocated)
+		grow_animation_slots ();
+
+	slot = animations.n_slots++;
+	animations.widget[slot] = (GtkWidget*) widget;
+	animations.start_time[slot] = update_frame_time ();
+	animations.start_modifier[slot] = 0.0;
+	animations.stop_time[slot] = stop_time;
+	animations.starting_state_type[slot] = prev_state;
+	animations.redrawn[slot] = animations.start_time[slot];
+
+	if (GTK_IS_PROGRESS_BAR (widget)) {
+		animations.damage[slot] = DAMAGE_FILL;
+	} else if (GTK_IS_CHECK_BUTTON (widget) && gtk_toggle_button_get_mode (GTK_TOGGLE_BUTTON (widget))) {
+		animations.damage[slot] = DAMAGE_INDICATOR;
+		get_indicator_area ((GtkWidget*) widget, &animations.indicator[slot]);
+	} else {
+		animations.damage[slot] = DAMAGE_FACE;
+	}
+
+	g_object_set_qdata (G_OBJECT (widget), animation_quark, GUINT_TO_POINTER (slot + 1));
+	g_object_weak_ref (G_OBJECT (widget), on_animated_widget_destruction, NULL);
+
+	/* connected while the widget is animated, with &animations as data */
+	g_signal_connect ((GObject*) widget, "expose-event", G_CALLBACK (on_animated_expose), &animations);
+	g_signal_connect_after ((GObject*) widget, "expose-event", G_CALLBACK (on_animated_expose_after), &animations);
+
+	watch_toplevel ((GtkWidget*) widget);
+	start_timer ();
 }
 
-/* update the animation information for each widget. This will also queue a redraw
- * and stop the animation if it is done. */
+/* TRUE on the ticks that fall every period milliseconds at the current
+ * interval, and on every tick if they are further apart than that */
 static gboolean
-update_animation_info (gpointer key, gpointer value, gpointer user_data)
+on_period (guint period)
 {
-	AnimationInfo *animation_info = value;
-	GtkWidget *widget = key;
-	gdouble elapsed;
+	guint n = period / MAX (animation_timer_interval, 1);
+
+	return n <= 1 || animation_tick % n == 0;
+}
+
+/* How fast a progress bar's stripes move, in pixels per second: a stripe
+ * period is twice as long as the fill is thick. */
+static gdouble
+get_stripe_speed (guint slot)
+{
+	GtkProgressBarOrientation orientation;
+	GdkRectangle area;
+	gint thickness;
+
+	get_damage_area (slot, &area);
+	orientation = gtk_progress_bar_get_orientation (GTK_PROGRESS_BAR (animations.widget[slot]));
+	if (orientation == GTK_PROGRESS_TOP_TO_BOTTOM || orientation == GTK_PROGRESS_BOTTOM_TO_TOP)
+		thickness = area.width;
+	else
+		thickness = area.height;
 
-	if ((widget == NULL) || (animation_info == NULL))
-		g_assert_not_reached ();
+	return MAX (thickness, 1) * 2 * PROGRESSBAR_SPEED;
+}
+
+/* When, on the animation clock, the stripes of a progress bar will have
+ * moved by a whole pixel since its last redraw.  In an unfocused window it
+ * also waits for its slower rate. */
+static gdouble
+get_stripe_due (guint slot, ToplevelRate rate)
+{
+	gdouble speed = get_stripe_speed (slot);
+	gdouble due = (floor (animations.redrawn[slot] * speed) + 1.0) / speed;
+
+	if (rate == TOPLEVEL_SLOW)
+		due = MAX (due, animations.redrawn[slot] + UNFOCUSED_ANIMATION_DELAY / 1000.0);
+
+	return due;
+}
 
-	/* remove the widget from the hash table if it is not drawable */
+/* update the animation in a slot. This will also queue a redraw and return
+ * FALSE if the animation is done. */
+static gboolean
+update_animation (guint slot, ToplevelRate rate)
+{
+	GtkWidget *widget = animations.widget[slot];
+	gboolean redraw;
+
+	/* stop animating the widget if it is not drawable */
 	if (!GTK_WIDGET_DRAWABLE (widget))
-		return TRUE;
+		return FALSE;
+
+	/* unfocused windows get every n-th tick while the timer runs faster
+	 * for another one, nothing at all while paused */
+	if (rate == TOPLEVEL_PAUSED)
+		redraw = FALSE;
+	else if (GTK_IS_PROGRESS_BAR (widget))
+		/* a millisecond early, as the timer is set in whole ones */
+		redraw = frame_time + 0.001 >= get_stripe_due (slot, rate);
+	else if (rate == TOPLEVEL_SLOW)
+		redraw = on_period (UNFOCUSED_ANIMATION_DELAY);
+	else
+		redraw = TRUE;
 
 	if (GTK_IS_PROGRESS_BAR (widget))
 	{
@@ -160,125 +670,322 @@ update_animation_info (gpointer key, gpointer value, gpointer user_data)
 
 		/* stop animation for filled/not filled progress bars */
 		if (fraction <= 0.0 || fraction >= 1.0)
-			return TRUE;
+			return FALSE;
+	}
+
+	if (redraw)
+		force_widget_redraw (slot);
+
+	/* stop at stop_time */
+	if (animations.stop_time[slot] != 0 && frame_time - animations.start_time[slot] > animations.stop_time[slot])
+		return FALSE;
+
+	return TRUE;
+}
+
+/* Updates all animations and returns the interval until the next tick,
+ * 0 if the timer should stop. */
+static guint
+run_tick ()
+{
+	gboolean running = FALSE, slow = FALSE;
+	gdouble stripes_due = G_MAXDOUBLE;
+	gdouble cost;
+	guint deadline = G_MAXUINT;
+	guint interval;
+	guint slot;
+
+	/*g_print("** TICK **\n");*/
+	animation_tick++;
+	animation_stats.ticks++;
+	animation_stats.timer_ms += animation_timer_interval;
+	if (slow_timer)
+		animation_stats.slow_ticks++;
+	update_frame_time ();
+
+	/* The last tick and the repaints after it went over the budget.  The
+	 * repaints cost in proportion to the damage the animations queue, so
+	 * fewer of them is what holds it down; the ones shed get their last
+	 * redraw from this tick. */
+	cost = tick_work + fold_repaint_time ();
+	if (tick_budget > 0 && cost > tick_budget)
+		shed_animations (cost);
+
+	if (tick_timer == NULL)
+		tick_timer = g_timer_new ();
+	g_timer_start (tick_timer);
+
+	/* backwards, so removing a slot only moves one that is done already */
+	for (slot = animations.n_slots; slot-- > 0;) {
+		ToplevelRate rate = get_toplevel_rate (animations.widget[slot]);
+
+		if (!update_animation (slot, rate)) {
+			stop_animation (slot);
+			continue;
+		}
+
+		/* progress bars only need a tick when their stripes move */
+		if (GTK_IS_PROGRESS_BAR (animations.widget[slot])) {
+			if (rate != TOPLEVEL_PAUSED)
+				stripes_due = MIN (stripes_due, get_stripe_due (slot, rate));
+			continue;
+		}
+
+		running |= rate == TOPLEVEL_RUNNING;
+		slow |= rate == TOPLEVEL_SLOW;
 
-		animation_info->update_delay--;
-		if (animation_info->update_delay <= 0) {
-			animation_info->update_delay = PROGRESSBAR_DELAY;
-			force_widget_redraw (widget);
+		/* milliseconds until the first visible transition ends */
+		if (rate != TOPLEVEL_PAUSED && animations.stop_time[slot] != 0) {
+			gdouble left = animations.stop_time[slot] - (frame_time - animations.start_time[slot]);
+
+			deadline = MIN (deadline, (guint) (left * 1000.0) + 1);
 		}
 	}
+
+	flush_damage ();
+	tick_work = g_timer_elapsed (tick_timer, NULL);
+
+	/* Only paused animations left: the timer stays off until one of their
+	 * windows is shown again.  Transitions that have run out by then are
+	 * finished by the next tick. */
+	if (running)
+		interval = frame_period;
+	else if (slow)
+		interval = MAX (UNFOCUSED_ANIMATION_DELAY, frame_period);
 	else
-		force_widget_redraw (widget);
+		interval = 0;
+	slow_timer = !running && slow;
+
+	/* frames skipped for a slow display, the transitions still end on time */
+	if (running && frame_period > ANIMATION_DELAY && interval / ANIMATION_DELAY > 1)
+		animation_stats.dropped_frames += interval / ANIMATION_DELAY - 1;
+	if (interval > ANIMATION_DELAY && deadline < interval)
+		interval = deadline;
+
+	/* The first tick on the frame_period grid after the stripes of a bar
+	 * have moved; every other bar that has moved by then is redrawn on the
+	 * same tick. */
+	if (stripes_due < G_MAXDOUBLE) {
+		gdouble wake = ceil (stripes_due * 1000.0 / frame_period) * frame_period;
+		guint stripes_interval = MAX (1, (guint) ceil (wake - frame_time * 1000.0));
+
+		if (interval == 0 || stripes_interval < interval)
+			interval = stripes_interval;
+	}
 
-	/* stop at stop_time */
-	if (animation_info->stop_time != 0 && g_timer_elapsed (animation_info->timer, NULL) > animation_info->stop_time)
-		return TRUE;
+	if (interval == 0 && animations.n_slots > 0)
+		animation_stats.stopped++;
 
-	return FALSE;
+	return interval;
 }
 
 /* This gets called by the glib main loop every once in a while. */
 static gboolean
 animation_timeout_handler (gpointer data)
 {
-	/* enter threads as update_animation_info will use gtk/gdk. */
-	gdk_threads_enter ();
-
-	/*g_print("** TICK **\n");*/
-	g_hash_table_foreach_remove (animated_widgets, update_animation_info, NULL);
+	int self = animation_timer_id;
+	guint interval;
 
-	/* leave again */
+	/* enter threads as update_animation will use gtk/gdk. */
+	gdk_threads_enter ();
+	interval = run_tick ();
 	gdk_threads_leave ();
 
-	if(g_hash_table_size(animated_widgets)==0)
-	{
-		stop_timer ();
+	/* something in the tick started or stopped the timer, which removed
+	 * this source; the timer it left is the one to keep */
+	if (animation_timer_id != self)
 		return FALSE;
+
+	if (interval == animation_timer_interval)
+		return TRUE;
+
+	/* this source is dropped by returning FALSE */
+	animation_timer_id = 0;
+	animation_timer_interval = 0;
+	if (interval != 0)
+		set_timer (interval);
+
+	return FALSE;
+}
+
+static gboolean
+on_toplevel_visibility (GtkWidget *toplevel, GdkEventVisibility *event, gpointer data)
+{
+	guint flags = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (toplevel), toplevel_quark));
+
+	if (event->state == GDK_VISIBILITY_FULLY_OBSCURED) {
+		flags |= TOPLEVEL_OBSCURED;
+	} else {
+		flags &= ~TOPLEVEL_OBSCURED;
+		if (animations.n_slots > 0)
+			start_timer ();
 	}
 
-	return TRUE;
+	g_object_set_qdata (G_OBJECT (toplevel), toplevel_quark, GUINT_TO_POINTER (flags));
+	return FALSE;
+}
+
+static gboolean
+on_toplevel_window_state (GtkWidget *toplevel, GdkEventWindowState *event, gpointer data)
+{
+	if (!(event->new_window_state & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)) && animations.n_slots > 0)
+		start_timer ();
+
+	return FALSE;
+}
+
+static gboolean
+on_toplevel_focus_in (GtkWidget *toplevel, GdkEventFocus *event, gpointer data)
+{
+	/* back to full rate; the next tick slows down again if need be */
+	if (animations.n_slots > 0)
+		start_timer ();
+
+	return FALSE;
 }
 
 static void
-on_checkbox_toggle (GtkWidget *widget, gpointer data)
+on_connected_widget_destruction (gpointer data, GObject *widget)
 {
-	AnimationInfo *animation_info = lookup_animation_info (widget);
+	g_hash_table_remove (connected_widgets, widget);
+}
 
-	if (animation_info != NULL)
-	{
-		gfloat elapsed = g_timer_elapsed (animation_info->timer, NULL);
-		animation_info->start_modifier = elapsed - animation_info->start_modifier;
-		animation_info->starting_state_type = GTK_STATE_ACTIVE;
-	}
-	else
-	{
-		add_animation (widget, CHECK_ANIMATION_TIME, GTK_STATE_ACTIVE, 0);
-	}
+static gboolean
+is_widget_connected (GtkWidget *widget)
+{
+	return connected_widgets != NULL && g_hash_table_lookup (connected_widgets, widget) != NULL;
 }
 
 static void
-on_button_toggle (GtkWidget *widget, GtkStateType prev_state, gpointer data)
+connect_widget_signal (GtkWidget *widget, const gchar *signal, GCallback callback)
 {
-	AnimationInfo *animation_info = lookup_animation_info (widget);
+	if (connected_widgets == NULL)
+		connected_widgets = g_hash_table_new (g_direct_hash, g_direct_equal);
 
-	if (animation_info != NULL) {
-		gfloat elapsed = g_timer_elapsed (animation_info->timer, NULL);
-		animation_info->start_modifier = elapsed - animation_info->start_modifier;
-		animation_info->starting_state_type = prev_state;
-	} else {
-		add_animation (widget, ANIMATION_TRANS_TIME, prev_state, 0);
+	if (!is_widget_connected (widget)) {
+		g_hash_table_insert (connected_widgets, widget, widget);
+		g_object_weak_ref (G_OBJECT (widget), on_connected_widget_destruction, NULL);
 	}
+
+	g_signal_connect ((GObject*) widget, signal, callback, &connected_widgets);
 }
 
-/*static void
-on_menuitem_select (GtkWidget *widget, GtkStateType prev_state, gpointer data)
+/* Follows the window the widget is in, so that its animations can be
+ * paused or slowed down.  The flags have no destroy notify, as the engine
+ * may be unloaded before the window goes away. */
+static void
+watch_toplevel (GtkWidget *widget)
 {
-	AnimationInfo *animation_info = lookup_animation_info (widget);
+	GtkWidget *toplevel = gtk_widget_get_toplevel (widget);
+	guint flags;
 
-	if (animation_info != NULL)	{
-		gfloat elapsed = g_timer_elapsed (animation_info->timer, NULL);
-		animation_info->start_modifier = elapsed - animation_info->start_modifier;
-		animation_info->starting_state_type = prev_state;
-	} else {
-		add_animation (widget, ANIMATION_TRANS_TIME, prev_state, 0);
-	}
-}*/
+	if (!GTK_IS_WINDOW (toplevel))
+		return;
+
+	if (toplevel_quark == 0)
+		toplevel_quark = g_quark_from_static_string ("equinox-animation-toplevel");
+
+	flags = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (toplevel), toplevel_quark));
+	if (flags & TOPLEVEL_WATCHED)
+		return;
+
+	/* GtkWindow selects structure and focus events itself */
+	if (toplevel->window)
+		gdk_window_set_events (toplevel->window, gdk_window_get_events (toplevel->window) | GDK_VISIBILITY_NOTIFY_MASK);
+	else
+		gtk_widget_add_events (toplevel, GDK_VISIBILITY_NOTIFY_MASK);
+
+	connect_widget_signal (toplevel, "visibility-notify-event", G_CALLBACK (on_toplevel_visibility));
+	connect_widget_signal (toplevel, "window-state-event", G_CALLBACK (on_toplevel_window_state));
+	connect_widget_signal (toplevel, "focus-in-event", G_CALLBACK (on_toplevel_focus_in));
+
+	g_object_set_qdata (G_OBJECT (toplevel), toplevel_quark, GUINT_TO_POINTER (flags | TOPLEVEL_WATCHED));
+}
 
+/* an animation that is restarted halfway runs back from where it was */
 static void
-on_connected_widget_destruction (gpointer data, GObject *widget)
+restart_animation (guint slot, GtkStateType prev_state)
 {
-	connected_widgets = g_slist_remove (connected_widgets, data);
-	g_free (data);
+	gdouble elapsed = update_frame_time () - animations.start_time[slot];
+
+	animations.start_modifier[slot] = elapsed - animations.start_modifier[slot];
+	animations.starting_state_type[slot] = prev_state;
 }
 
+/* the check mark fades, the state the indicator is drawn in stays */
 static void
-disconnect_all_signals ()
+on_checkbox_toggle (GtkWidget *widget, gpointer data)
 {
-	GSList * item = connected_widgets;
-	while (item != NULL)
-	{
-		SignalInfo *signal_info = (SignalInfo*) item->data;
+	gint slot = lookup_animation_slot (widget);
 
-		g_signal_handler_disconnect (signal_info->widget, signal_info->handler_id);
-		g_object_weak_unref (G_OBJECT (signal_info->widget), on_connected_widget_destruction, signal_info);
-		g_free (signal_info);
+	if (slot >= 0)
+		restart_animation (slot, GTK_WIDGET_STATE (widget));
+	else
+		add_animation (widget, CHECK_ANIMATION_TIME, GTK_WIDGET_STATE (widget));
+}
 
-		item = g_slist_next (item);
-	}
+static void
+on_button_toggle (GtkWidget *widget, GtkStateType prev_state, gpointer data)
+{
+	gint slot = lookup_animation_slot (widget);
 
-	g_slist_free (connected_widgets);
-	connected_widgets = NULL;
+	if (slot >= 0)
+		restart_animation (slot, prev_state);
+	else
+		add_animation (widget, ANIMATION_TRANS_TIME, prev_state);
 }
 
-/* helper function for equinox_animation_connect_checkbox */
-static gint
-find_signal_info (gconstpointer signal_info, gconstpointer widget)
+static void
+on_menuitem_select (GtkWidget *widget, GtkStateType prev_state, gpointer data)
 {
-	if (((SignalInfo*)signal_info)->widget == widget)
-		return 0;
+	gint slot = lookup_animation_slot (widget);
+
+	/* an item that is not selected is not drawn at all */
+	if (GTK_WIDGET_STATE (widget) != GTK_STATE_PRELIGHT)
+		return;
+
+	if (slot >= 0)
+		restart_animation (slot, prev_state);
 	else
-		return 1;
+		add_animation (widget, ANIMATION_TRANS_TIME, prev_state);
+}
+
+/* entries animate their focus, their state stays the same */
+static gboolean
+on_entry_focus_change (GtkWidget *widget, GdkEventFocus *event, gpointer data)
+{
+	gint slot = lookup_animation_slot (widget);
+
+	if (slot >= 0)
+		restart_animation (slot, GTK_WIDGET_STATE (widget));
+	else
+		add_animation (widget, ANIMATION_TRANS_TIME, GTK_WIDGET_STATE (widget));
+
+	return FALSE;
+}
+
+static void
+disconnect_widget (gpointer key, gpointer value, gpointer data)
+{
+	GObject *widget = key;
+
+	g_signal_handlers_disconnect_matched (widget, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, &connected_widgets);
+	g_object_weak_unref (widget, on_connected_widget_destruction, NULL);
+
+	/* watch toplevels again should the engine be loaded again */
+	if (toplevel_quark != 0)
+		g_object_set_qdata (widget, toplevel_quark, NULL);
+}
+
+static void
+disconnect_all_signals ()
+{
+	if (connected_widgets == NULL)
+		return;
+
+	g_hash_table_foreach (connected_widgets, disconnect_widget, NULL);
+	g_hash_table_destroy (connected_widgets);
+	connected_widgets = NULL;
 }
 
 
@@ -291,98 +998,190 @@ equinox_animation_progressbar_add (GtkWidget *progressbar)
 	gdouble fraction = gtk_progress_bar_get_fraction (GTK_PROGRESS_BAR (progressbar));
 
 	if (fraction < 1.0 && fraction > 0.0) {
-		add_animation ((GtkWidget*) progressbar, 0.0, GTK_STATE_NORMAL, PROGRESSBAR_DELAY);
+		add_animation ((GtkWidget*) progressbar, 0.0, GTK_STATE_NORMAL);
 	}
 }
 
+/* Returns where the stripes are within their period, from 0 to 1.  It is
+ * taken from the animation clock, so all progress bars move in step. */
+gdouble
+equinox_animation_progressbar_phase ()
+{
+	if (animation_clock == NULL && virtual_clock == NULL)
+		update_frame_time ();
+
+	return fmod (frame_time * PROGRESSBAR_SPEED, 1.0);
+}
+
 /* hooks up the signals for check and radio buttons */
 void
 equinox_animation_connect_checkbox (GtkWidget *widget)
 {
-	if (GTK_IS_CHECK_BUTTON (widget))
-	{
-		if (!g_slist_find_custom (connected_widgets, widget, find_signal_info))
-		{
-			SignalInfo * signal_info = g_new (SignalInfo, 1);
-
-			signal_info->widget = widget;
-			signal_info->handler_id = g_signal_connect ((GObject*)widget, "toggled", G_CALLBACK (on_checkbox_toggle), NULL);
-
-			connected_widgets = g_slist_append (connected_widgets, signal_info);
-			g_object_weak_ref (G_OBJECT (widget), on_connected_widget_destruction, signal_info);
-		}
-	}
+	if (GTK_IS_CHECK_BUTTON (widget) && !is_widget_connected (widget))
+		connect_widget_signal (widget, "toggled", G_CALLBACK (on_checkbox_toggle));
 }
 
 /* hooks up the signals for buttons */
 void
 equinox_animation_connect_button (GtkWidget *widget)
 {
-	if (GTK_IS_BUTTON(widget))
-	{
-		if (!g_slist_find_custom (connected_widgets, widget, find_signal_info))
-		{
-			SignalInfo * signal_info = g_new (SignalInfo, 1);
-
-			signal_info->widget = widget;
-			signal_info->handler_id = g_signal_connect ((GObject*)widget, "state-changed", G_CALLBACK (on_button_toggle), NULL);
-
-			connected_widgets = g_slist_append (connected_widgets, signal_info);
-			g_object_weak_ref (G_OBJECT (widget), on_connected_widget_destruction, signal_info);
-		}
-	}
+	if (GTK_IS_BUTTON (widget) && !is_widget_connected (widget))
+		connect_widget_signal (widget, "state-changed", G_CALLBACK (on_button_toggle));
 }
 
 /* hooks up the signals for menuitems */
-/*void
+void
 equinox_animation_connect_menuitem (GtkWidget *widget)
 {
-	if (GTK_IS_MENU_ITEM(widget))
+	if (GTK_IS_MENU_ITEM (widget) && !is_widget_connected (widget))
+		connect_widget_signal (widget, "state-changed", G_CALLBACK (on_menuitem_select));
+}
+
+/* hooks up the signals for entries */
+void
+equinox_animation_connect_entry (GtkWidget *widget)
+{
+	if (GTK_IS_ENTRY (widget) && !is_widget_connected (widget))
 	{
-		if (!g_slist_find_custom (connected_widgets, widget, find_signal_info))
-		{
-			SignalInfo * signal_info = g_new (SignalInfo, 1);
+		connect_widget_signal (widget, "focus-in-event", G_CALLBACK (on_entry_focus_change));
+		connect_widget_signal (widget, "focus-out-event", G_CALLBACK (on_entry_focus_change));
+	}
+}
 
-			signal_info->widget = widget;
-			signal_info->handler_id = g_signal_connect ((GObject*)widget, "state-changed", G_CALLBACK (on_menuitem_select), NULL);
+/* For widgets that are drawn in another state without changing theirs,
+ * like a scrollbar whose slider is under the pointer: starts a transition
+ * when the state a widget is drawn in differs from the last one. */
+void
+equinox_animation_track_state (GtkWidget *widget, GtkStateType state_type)
+{
+	guint last;
+	gint slot;
 
-			connected_widgets = g_slist_append (connected_widgets, signal_info);
-			g_object_weak_ref (G_OBJECT (widget), on_connected_widget_destruction, signal_info);
-		}
-	}
-}*/
+	if (widget == NULL)
+		return;
+
+	if (drawn_state_quark == 0)
+		drawn_state_quark = g_quark_from_static_string ("equinox-animation-drawn-state");
 
-/* returns TRUE if the widget is animated, and FALSE otherwise */
+	/* stored as state + 1, without a destroy notify */
+	last = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (widget), drawn_state_quark));
+	if (last == (guint) state_type + 1)
+		return;
+
+	g_object_set_qdata (G_OBJECT (widget), drawn_state_quark, GUINT_TO_POINTER (state_type + 1));
+	if (last == 0)
+		return;
+
+	slot = lookup_animation_slot (widget);
+	if (slot >= 0)
+		restart_animation (slot, last - 1);
+	else
+		add_animation (widget, ANIMATION_TRANS_TIME, last - 1);
+}
+
+/* Everything a draw needs to know about the widget's animation in one
+ * lookup.  Returns FALSE, with the state of a finished animation, if the
+ * widget is not animated. */
 gboolean
-equinox_animation_is_animated (GtkWidget *widget)
+equinox_animation_lookup (GtkWidget *widget, EquinoxAnimationState *state)
+{
+	gint slot = lookup_animation_slot (widget);
+
+	if (slot < 0) {
+		state->elapsed = 0.0;
+		state->starting_state_type = GTK_STATE_NORMAL;
+		return FALSE;
+	}
+
+	state->elapsed = frame_time - animations.start_time[slot] - animations.start_modifier[slot];
+	state->starting_state_type = animations.starting_state_type[slot];
+	return TRUE;
+}
+
+/* Replaces the clock, for replaying animations with the same timing every
+ * time; NULL goes back to real time.  Best done while nothing is animated,
+ * as running animations keep their start times.  While a virtual clock is
+ * set there is no main loop timer, equinox_animation_tick has to be called
+ * for every tick instead. */
+void
+equinox_animation_set_clock (EquinoxAnimationClockFunc clock, gpointer data)
 {
-	return lookup_animation_info (widget) != NULL ? TRUE : FALSE;
+	guint interval = animation_timer_interval;
+
+	stop_timer ();
+
+	virtual_clock = clock;
+	virtual_clock_data = data;
+	update_frame_time ();
+
+	redraw_cost = 0.0;
+	frame_period = ANIMATION_DELAY;
+
+	if (interval != 0)
+		set_timer (interval);
 }
 
-/* returns the elapsed time for the animation */
-gdouble
-equinox_animation_elapsed (gpointer data)
+/* Runs a tick now, with a virtual clock.  Returns the interval in
+ * milliseconds until the next tick should be run, 0 if there is nothing to
+ * tick until an animation starts. */
+guint
+equinox_animation_tick ()
 {
-	AnimationInfo *animation_info = lookup_animation_info (data);
+	guint interval = animation_timer_interval;
+	guint next;
 
-	if (animation_info)
-		return   g_timer_elapsed (animation_info->timer, NULL)- animation_info->start_modifier;
-	else
-		return 0.0;
+	g_return_val_if_fail (virtual_clock != NULL, 0);
+
+	if (interval == 0)
+		return 0;
+
+	next = run_tick ();
+
+	/* as with the main loop timer, one set during the tick wins */
+	if (animation_timer_interval == interval)
+		animation_timer_interval = next;
+
+	return animation_timer_interval;
 }
 
-/* returns the origional state_type for the animation */
-GtkStateType
-equinox_animation_starting_state (gpointer data)
+void
+equinox_animation_get_stats (EquinoxAnimationStats *stats)
 {
-	AnimationInfo *animation_info = lookup_animation_info (data);
+	*stats = animation_stats;
+	stats->animations = animations.n_slots;
+}
 
-	if (animation_info)
-		return animation_info->starting_state_type;
-	else
-		return GTK_STATE_NORMAL;
+/* Sets the budget: how many animations may run at once and how long in
+ * milliseconds a tick may take, 0 for no limit.  The scheduler is shared
+ * by all styles, the last one set up with animation on decides. */
+void
+equinox_animation_set_limits (guint max_running, gdouble tick_budget_ms)
+{
+	max_animations = max_running;
+	tick_budget = tick_budget_ms / 1000.0;
 }
 
+/* prints the repainted area, per second of running animations */
+void
+equinox_animation_print_stats ()
+{
+	gdouble seconds = animation_stats.timer_ms / 1000.0;
+
+	if (seconds <= 0.0)
+		return;
+
+	g_printerr ("equinox: animations: %lu ticks, %.0f pixels repainted per second, %.0f when redrawing whole widgets\n",
+	            animation_stats.ticks, animation_stats.pixels / seconds, animation_stats.widget_pixels / seconds);
+	g_printerr ("equinox: animations: %lu widget redraws batched into %lu window invalidations\n",
+	            animation_stats.damaged_widgets, animation_stats.invalidations);
+	g_printerr ("equinox: animations: %lu ticks at the unfocused rate, timer stopped %lu times for hidden windows\n",
+	            animation_stats.slow_ticks, animation_stats.stopped);
+	g_printerr ("equinox: animations: %lu snapped to their end over the budget\n",
+	            animation_stats.snapped);
+	g_printerr ("equinox: animations: %.1f frames per second, %lu frames dropped, %.2f ms per redraw\n",
+	            animation_stats.frames / seconds, animation_stats.dropped_frames,
+	            animation_stats.frames ? animation_stats.redraw_time * 1000.0 / animation_stats.frames : 0.0);
+}
 
 /* cleans up all resources of the animation system */
 void
@@ -390,14 +1189,68 @@ equinox_animation_cleanup ()
 {
 	disconnect_all_signals ();
 
-	if (animated_widgets != NULL)
+	while (animations.n_slots > 0)
+		remove_animation_slot (animations.n_slots - 1, FALSE);
+
+	g_free (animations.widget);
+	g_free (animations.start_time);
+	g_free (animations.start_modifier);
+	g_free (animations.stop_time);
+	g_free (animations.starting_state_type);
+	g_free (animations.damage);
+	g_free (animations.indicator);
+	g_free (animations.redrawn);
+	memset (&animations, 0, sizeof (animations));
+
+	stop_timer ();
+
+	if (pending_damage != NULL)
 	{
-		g_hash_table_destroy (animated_widgets);
-		animated_widgets = NULL;
+		g_hash_table_destroy (pending_damage);
+		pending_damage = NULL;
 	}
 
-	stop_timer ();
+	if (animation_clock != NULL)
+	{
+		g_timer_destroy (animation_clock);
+		animation_clock = NULL;
+	}
+
+	if (tick_timer != NULL)
+	{
+		g_timer_destroy (tick_timer);
+		tick_timer = NULL;
+	}
+
+	if (redraw_timer != NULL)
+	{
+		g_timer_destroy (redraw_timer);
+		redraw_timer = NULL;
+	}
+	tick_work = 0.0;
+	repaint_timing = FALSE;
+	repaint_time = 0.0;
+	damage_flushed = FALSE;
+	redraw_cost = 0.0;
+	frame_period = ANIMATION_DELAY;
+	slow_timer = FALSE;
 }
 
+static const EquinoxAnimationHooks animation_hooks = {
+	equinox_animation_connect_button,
+	equinox_animation_connect_checkbox,
+	equinox_animation_connect_menuitem,
+	equinox_animation_connect_entry,
+	equinox_animation_track_state,
+	equinox_animation_progressbar_add,
+	equinox_animation_progressbar_phase,
+	equinox_animation_lookup,
+	equinox_animation_set_limits
+};
 
-#endif /* HAVE_ANIMATION */
+/* the hooks for a style, from its animation setting */
+const EquinoxAnimationHooks *
+equinox_animation_get_hooks (gboolean enabled)
+{
+	return enabled ? &animation_hooks : NULL;
+}
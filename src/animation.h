@@ -16,25 +16,84 @@
  * Boston, MA 02111-1307, USA.
  */
 
+#ifndef EQUINOX_ANIMATION_H
+#define EQUINOX_ANIMATION_H
+
 #include "config.h"
 
-#ifdef HAVE_ANIMATION
 #include <gtk/gtk.h>
 
 #define EQX_IS_PROGRESS_BAR(widget) GTK_IS_PROGRESS_BAR(widget) && widget->allocation.x != -1 && widget->allocation.y != -1
 #define ANIMATION_DELAY 25
-#define PROGRESSBAR_DELAY 5
+#define UNFOCUSED_ANIMATION_DELAY 100
+#define MAX_ANIMATION_DELAY 200
+#define PROGRESSBAR_SPEED 1.0	/* stripe periods per second */
 #define CHECK_ANIMATION_TIME 0.5
 #define ANIMATION_TRANS_TIME 0.25
+/* default budget: animations running at once, milliseconds per tick */
+#define ANIMATION_LIMIT 32
+#define ANIMATION_BUDGET 10.0
+#define MAX_ANIMATION_LIMIT 1024
+
+typedef struct {
+	gdouble elapsed;
+	GtkStateType starting_state_type;
+} EquinoxAnimationState;
+
+/* Returns the time in seconds.  Set one with equinox_animation_set_clock
+ * to step the animations by hand instead of by the main loop. */
+typedef gdouble (*EquinoxAnimationClockFunc) (gpointer data);
+
+/* Redrawn area compared with what redrawing the whole widgets would cost */
+typedef struct {
+	gulong  ticks;
+	gulong  timer_ms;	/* time covered by the ticks */
+	gulong  slow_ticks;
+	gulong  stopped;	/* timer stopped with only paused animations left */
+	guint64 pixels;
+	guint64 widget_pixels;
+	gulong  damaged_widgets;
+	gulong  invalidations;
+	gulong  dirtied_bars;	/* progress bars told to repaint their pixmap */
+	gulong  snapped;	/* animations skipped or cut short by the budget */
+	gulong  frames;		/* ticks that repainted anything */
+	gulong  dropped_frames;	/* left out as the redraws were too slow */
+	gdouble redraw_time;	/* seconds animated widgets spent repainting */
+	guint   animations;	/* running now */
+} EquinoxAnimationStats;
+
+/* The style reaches the animation code only through these.  A style with
+ * animation turned off has no hooks at all, so its draws do not connect
+ * signals, look up anything or mix colours. */
+typedef struct {
+	void     (*connect_button)    (GtkWidget *widget);
+	void     (*connect_checkbox)  (GtkWidget *widget);
+	void     (*connect_menuitem)  (GtkWidget *widget);
+	void     (*connect_entry)     (GtkWidget *widget);
+	void     (*track_state)       (GtkWidget *widget, GtkStateType state_type);
+	void     (*progressbar_add)   (GtkWidget *progressbar);
+	gdouble  (*progressbar_phase) (void);
+	gboolean (*lookup)            (GtkWidget *widget, EquinoxAnimationState *state);
+	void     (*set_limits)        (guint max_running, gdouble tick_budget);
+} EquinoxAnimationHooks;
+
+/* NULL when disabled */
+G_GNUC_INTERNAL const EquinoxAnimationHooks *equinox_animation_get_hooks (gboolean enabled);
 
 G_GNUC_INTERNAL void     equinox_animation_progressbar_add (GtkWidget *progressbar);
+G_GNUC_INTERNAL gdouble  equinox_animation_progressbar_phase ();
 G_GNUC_INTERNAL void     equinox_animation_connect_checkbox (GtkWidget *widget);
 G_GNUC_INTERNAL void     equinox_animation_connect_button (GtkWidget *widget);
 G_GNUC_INTERNAL void     equinox_animation_connect_entry (GtkWidget *widget);
-//G_GNUC_INTERNAL void     equinox_animation_connect_menuitem (GtkWidget *widget);
+G_GNUC_INTERNAL void     equinox_animation_connect_menuitem (GtkWidget *widget);
 G_GNUC_INTERNAL void     equinox_animation_connect_widget (GtkWidget *widget);
-G_GNUC_INTERNAL gboolean equinox_animation_is_animated (GtkWidget *widget);
-G_GNUC_INTERNAL gdouble  equinox_animation_elapsed (gpointer data);
-G_GNUC_INTERNAL GtkStateType  equinox_animation_starting_state (gpointer data);
+G_GNUC_INTERNAL void     equinox_animation_track_state (GtkWidget *widget, GtkStateType state_type);
+G_GNUC_INTERNAL gboolean equinox_animation_lookup (GtkWidget *widget, EquinoxAnimationState *state);
+G_GNUC_INTERNAL void     equinox_animation_set_limits (guint max_running, gdouble tick_budget);
+G_GNUC_INTERNAL void     equinox_animation_set_clock (EquinoxAnimationClockFunc clock, gpointer data);
+G_GNUC_INTERNAL guint    equinox_animation_tick ();
+G_GNUC_INTERNAL void     equinox_animation_get_stats (EquinoxAnimationStats *stats);
+G_GNUC_INTERNAL void     equinox_animation_print_stats ();
 G_GNUC_INTERNAL void     equinox_animation_cleanup ();
-#endif /* HAVE_ANIMATION */
+
+#endif /* EQUINOX_ANIMATION_H */
@@ -0,0 +1,904 @@
+/* Equinox Engine
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Headless micro-benchmark for the drawing primitives.
+ *
+ * The equinox_draw_* functions only need a cairo context, a palette and
+ * plain parameter structs, so they are driven here straight into an image
+ * surface, without an X server or any widgets.  Every primitive is run over
+ * a matrix of sizes, states and style variants, with and without the render
+ * caches, and the timings are written to stdout as JSON.
+ *
+ * Given a display, a button box is also painted through the style's own
+ * entry point, gtk_paint_box, on an Equinox style with animation off and
+ * on, and on the animated style with its hooks taken away, which is what a
+ * build without animation would draw.  Only the hook checks differ between
+ * that one and animation off, which should cost the same; with animation
+ * on the cost per button should not grow with the number of buttons.
+ *
+ * The replay runs the animation scheduler on a virtual clock over a window
+ * of buttons going in and out of prelight and of progress bars, and writes
+ * for every tick its CPU time, the time the animated widgets took to
+ * repaint after it, and the area it invalidated.  It fails if a progress
+ * bar it damaged did not repaint its stripes.  Nothing in it depends on
+ * real time, so two runs tick the same way and only the CPU times differ.  It needs a display for the widgets, Xvfb is enough.
+ *
+ *   make bench
+ *   ./equinox-bench --time=0.2 --filter=button
+ *   xvfb-run ./equinox-bench --filter=replay --frames=400 --widgets=200
+ */
+
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <glib.h>
+#include <cairo.h>
+
+#include "equinox_draw.h"
+#include "equinox_style.h"
+#include "equinox_rc_style.h"
+#include "equinox_cache.h"
+#include "support.h"
+#include "animation.h"
+
+typedef void (*BenchFunc) (cairo_t *cr, const EquinoxColors *colors,
+                           WidgetParameters *widget, int width, int height, int variant);
+
+typedef struct {
+	const char *name;
+	BenchFunc   func;
+	int         variants;	/* style variants, passed as variant */
+	gboolean    fixed_size;	/* draws at its own size whatever is asked */
+} BenchPrimitive;
+
+typedef struct {
+	int width;
+	int height;
+} BenchSize;
+
+static const BenchSize bench_sizes[] = {
+	{  16,  16 },
+	{  24,  24 },
+	{  80,  28 },
+	{ 200,  32 },
+	{ 400, 100 }
+};
+
+static const struct {
+	const char      *name;
+	EquinoxStateType state_type;
+	boolean          prelight;
+	boolean          active;
+	boolean          disabled;
+} bench_states[] = {
+	{ "normal",      (EquinoxStateType) GTK_STATE_NORMAL,      FALSE, FALSE, FALSE },
+	{ "prelight",    (EquinoxStateType) GTK_STATE_PRELIGHT,    TRUE,  FALSE, FALSE },
+	{ "active",      (EquinoxStateType) GTK_STATE_ACTIVE,      FALSE, TRUE,  FALSE },
+	{ "selected",    (EquinoxStateType) GTK_STATE_SELECTED,    FALSE, FALSE, FALSE },
+	{ "insensitive", (EquinoxStateType) GTK_STATE_INSENSITIVE, FALSE, FALSE, TRUE  }
+};
+
+static void
+bench_button (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_button (cr, colors, widget, 0, 0, width, height, variant);
+}
+
+static void
+bench_entry (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	EntryParameters entry;
+
+	entry.type = EQX_ENTRY_NORMAL;
+	entry.isComboButton = FALSE;
+	entry.isSpinButton = FALSE;
+	entry.isToolbarItem = FALSE;
+
+	equinox_draw_entry (cr, colors, widget, &entry, 0, 0, width, height, variant);
+}
+
+static void
+bench_tab (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	TabParameters tab;
+
+	tab.gap_side = (EquinoxGapSide) variant;
+	tab.first_tab = FALSE;
+	tab.last_tab = FALSE;
+
+	equinox_draw_tab (cr, colors, widget, &tab, 0, 0, width, height);
+}
+
+static void
+bench_frame (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	FrameParameters frame;
+
+	frame.shadow = variant ? EQX_SHADOW_ETCHED_IN : EQX_SHADOW_IN;
+	frame.gap_side = EQX_GAP_TOP;
+	frame.gap_x = -1;
+	frame.gap_width = 0;
+	frame.border = (EquinoxRGB *) &colors->shade[4];
+	frame.fill = NULL;
+	frame.use_fill = FALSE;
+	frame.fill_bg = FALSE;
+
+	equinox_draw_frame (cr, colors, widget, &frame, 0, 0, width, height);
+}
+
+static void
+bench_scrollbar_slider (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	ScrollBarParameters scrollbar;
+
+	memset (&scrollbar, 0, sizeof (ScrollBarParameters));
+	scrollbar.horizontal = TRUE;
+
+	equinox_draw_scrollbar_slider (cr, colors, widget, &scrollbar, 0, 0, width, height, variant, 0);
+}
+
+static void
+bench_scrollbar_stepper (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	ScrollBarParameters scrollbar;
+
+	memset (&scrollbar, 0, sizeof (ScrollBarParameters));
+	scrollbar.horizontal = TRUE;
+
+	equinox_draw_scrollbar_stepper (cr, colors, widget, &scrollbar, 0, 0, width, height, variant, 0);
+}
+
+static void
+bench_scrollbar_trough (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	ScrollBarParameters scrollbar;
+
+	memset (&scrollbar, 0, sizeof (ScrollBarParameters));
+	scrollbar.horizontal = TRUE;
+
+	equinox_draw_scrollbar_trough (cr, colors, widget, &scrollbar, 0, 0, width, height, 0, variant);
+}
+
+static void
+bench_progressbar_trough (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	ProgressBarParameters progressbar;
+
+	progressbar.orientation = EQX_ORIENTATION_LEFT_TO_RIGHT;
+	progressbar.style = EQX_PROGRESSBAR_CONTINUOUS;
+	progressbar.fraction = 0.5;
+
+	equinox_draw_progressbar_trough (cr, colors, widget, &progressbar, 0, 0, width, height, variant);
+}
+
+static void
+bench_progressbar_fill (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	static int step = 0;
+	ProgressBarParameters progressbar;
+
+	progressbar.orientation = EQX_ORIENTATION_LEFT_TO_RIGHT;
+	progressbar.style = EQX_PROGRESSBAR_CONTINUOUS;
+	progressbar.fraction = 0.5;
+
+	/* walk through the animation phases like a running bar does */
+	step = (step + 1) % 10;
+
+	equinox_draw_progressbar_fill (cr, colors, widget, &progressbar, 0, 0, width, height, step / 10.0, variant);
+}
+
+static void
+bench_scale_trough (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	SliderParameters slider;
+
+	slider.inverted = FALSE;
+	slider.horizontal = TRUE;
+	slider.fill_size = width / 2;
+
+	equinox_draw_scale_trough (cr, colors, widget, &slider, 0, 0, width, height);
+}
+
+static void
+bench_scale_slider (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	SliderParameters slider;
+
+	slider.inverted = FALSE;
+	slider.horizontal = TRUE;
+	slider.fill_size = 0;
+
+	equinox_draw_scale_slider (cr, colors, widget, &slider, 0, 0, width, height, variant);
+}
+
+static void
+bench_checkbutton (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	OptionParameters option;
+
+	option.draw_bullet = TRUE;
+	option.inconsistent = FALSE;
+
+	equinox_draw_checkbutton (cr, colors, widget, &option, 0, 0, width, height, variant);
+}
+
+static void
+bench_radiobutton (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	OptionParameters option;
+
+	option.draw_bullet = TRUE;
+	option.inconsistent = FALSE;
+
+	equinox_draw_radiobutton (cr, colors, widget, &option, 0, 0, width, height, variant);
+}
+
+static void
+bench_cell_checkbutton (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	OptionParameters option;
+
+	option.draw_bullet = TRUE;
+	option.inconsistent = FALSE;
+
+	equinox_draw_cell_checkbutton (cr, colors, widget, &option, 0, 0, width, height);
+}
+
+static void
+bench_arrow (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	ArrowParameters arrow;
+
+	arrow.type = EQX_ARROW_NORMAL;
+	arrow.direction = (EquinoxDirection) variant;
+	arrow.size = 7;
+
+	equinox_draw_arrow (cr, colors, widget, &arrow, 0, 0, width, height);
+}
+
+static void
+bench_handle (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	HandleParameters handle;
+
+	handle.type = EQX_HANDLE_TOOLBAR;
+	handle.horizontal = TRUE;
+
+	equinox_draw_handle (cr, colors, widget, &handle, 0, 0, width, height);
+}
+
+static void
+bench_list_view_header (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	ListViewHeaderParameters header;
+
+	header.order = EQX_ORDER_MIDDLE;
+	header.resizable = TRUE;
+	header.sorted = FALSE;
+
+	equinox_draw_list_view_header (cr, colors, widget, &header, 0, 0, width, height, variant);
+}
+
+static void
+bench_list_item (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_list_item (cr, colors, widget, 0, 0, width, height, variant);
+}
+
+static void
+bench_list_selection (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_list_selection (cr, colors, widget, 0, 0, width, height);
+}
+
+static void
+bench_menubar (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_menubar (cr, colors, widget, 0, 0, width, height, variant, 1);
+}
+
+static void
+bench_menuitem (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_menuitem (cr, colors, widget, 0, 0, width, height, variant);
+}
+
+static void
+bench_menu_frame (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_menu_frame (cr, colors, widget, 0, 0, width, height);
+}
+
+static void
+bench_toolbar (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_toolbar (cr, colors, widget, 0, 0, width, height, variant);
+}
+
+static void
+bench_separator (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	SeparatorParameters separator;
+
+	separator.horizontal = TRUE;
+	separator.inToolbar = FALSE;
+
+	equinox_draw_separator (cr, colors, widget, &separator, 0, 0, width, height, variant);
+}
+
+static void
+bench_tooltip (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	equinox_draw_tooltip (cr, colors, widget, 0, 0, width, height);
+}
+
+static void
+bench_resize_grip (cairo_t *cr, const EquinoxColors *colors, WidgetParameters *widget, int width, int height, int variant)
+{
+	ResizeGripParameters grip;
+
+	grip.edge = EQX_WINDOW_EDGE_SOUTH_EAST;
+
+	equinox_draw_resize_grip (cr, colors, widget, &grip, 0, 0, width, height, variant);
+}
+
+static const BenchPrimitive bench_primitives[] = {
+	{ "button",             bench_button,             2, FALSE },
+	{ "entry",              bench_entry,              2, FALSE },
+	{ "tab",                bench_tab,                4, FALSE },
+	{ "frame",              bench_frame,              2, FALSE },
+	{ "scrollbar_slider",   bench_scrollbar_slider,   4, FALSE },
+	{ "scrollbar_stepper",  bench_scrollbar_stepper,  4, FALSE },
+	{ "scrollbar_trough",   bench_scrollbar_trough,   2, FALSE },
+	{ "progressbar_trough", bench_progressbar_trough, 2, FALSE },
+	{ "progressbar_fill",   bench_progressbar_fill,   2, FALSE },
+	{ "scale_trough",       bench_scale_trough,       1, FALSE },
+	{ "scale_slider",       bench_scale_slider,       2, FALSE },
+	{ "checkbutton",        bench_checkbutton,        2, TRUE  },
+	{ "radiobutton",        bench_radiobutton,        2, TRUE  },
+	{ "cell_checkbutton",   bench_cell_checkbutton,   1, TRUE  },
+	{ "arrow",              bench_arrow,              4, FALSE },
+	{ "handle",             bench_handle,             1, FALSE },
+	{ "list_view_header",   bench_list_view_header,   2, FALSE },
+	{ "list_item",          bench_list_item,          2, FALSE },
+	{ "list_selection",     bench_list_selection,     1, FALSE },
+	{ "menubar",            bench_menubar,            2, FALSE },
+	{ "menuitem",           bench_menuitem,           2, FALSE },
+	{ "menu_frame",         bench_menu_frame,         1, FALSE },
+	{ "toolbar",            bench_toolbar,            2, FALSE },
+	{ "separator",          bench_separator,          2, FALSE },
+	{ "tooltip",            bench_tooltip,            1, FALSE },
+	{ "resize_grip",        bench_resize_grip,        2, FALSE }
+};
+
+/* The stock Equinox colours, the way equinox_style_realize would set them
+ * up from a gtkrc with contrast 1.0. */
+static void
+bench_init_colors (EquinoxColors *colors, int buttonstyle)
+{
+	static const double shades[] = { 1.15, 1.04, 0.94, 0.80, 0.70, 0.64, 0.5, 0.45, 0.4 };
+	static const EquinoxRGB bg[5]   = { { 0.91, 0.91, 0.91 }, { 0.85, 0.85, 0.85 }, { 0.95, 0.95, 0.95 }, { 0.30, 0.52, 0.78 }, { 0.91, 0.91, 0.91 } };
+	static const EquinoxRGB base[5] = { { 1.00, 1.00, 1.00 }, { 0.66, 0.73, 0.84 }, { 1.00, 1.00, 1.00 }, { 0.30, 0.52, 0.78 }, { 0.95, 0.95, 0.95 } };
+	static const EquinoxRGB text[5] = { { 0.10, 0.10, 0.10 }, { 0.10, 0.10, 0.10 }, { 0.10, 0.10, 0.10 }, { 1.00, 1.00, 1.00 }, { 0.55, 0.55, 0.55 } };
+	int i;
+
+	memset (colors, 0, sizeof (EquinoxColors));
+
+	for (i = 0; i < 9; i++)
+		equinox_shade (&bg[GTK_STATE_NORMAL], &colors->shade[i], shades[i]);
+
+	equinox_shade (&bg[GTK_STATE_SELECTED], &colors->spot[0], 1.42);
+	equinox_shade (&bg[GTK_STATE_SELECTED], &colors->spot[1], 1.00);
+	equinox_shade (&bg[GTK_STATE_SELECTED], &colors->spot[2], 0.65);
+
+	for (i = 0; i < 5; i++) {
+		colors->bg[i] = bg[i];
+		colors->base[i] = base[i];
+		colors->text[i] = text[i];
+		colors->fg[i] = text[i];
+	}
+
+	colors->fingerprint = equinox_cache_palette_fingerprint (colors);
+	equinox_derive_colors (colors, buttonstyle);
+}
+
+static void
+bench_init_widget (WidgetParameters *widget, const EquinoxColors *colors, int state)
+{
+	memset (widget, 0, sizeof (WidgetParameters));
+
+	widget->state_type = bench_states[state].state_type;
+	widget->prev_state_type = widget->state_type;
+	widget->prelight = bench_states[state].prelight;
+	widget->active = bench_states[state].active;
+	widget->disabled = bench_states[state].disabled;
+	widget->corners = EQX_CORNER_ALL;
+	widget->xthickness = 2;
+	widget->ythickness = 2;
+	widget->trans = 1.0;
+	widget->curvature = 4.0;
+
+	/* no widget to look things up on */
+	widget->own_lazy.source = NULL;
+	widget->own_lazy.pending = 0;
+	widget->own_lazy.parentbg = colors->bg[GTK_STATE_NORMAL];
+	widget->own_lazy.ltr = TRUE;
+	widget->lazy = &widget->own_lazy;
+}
+
+/* One draw call the way the style does it: a fresh context per call. */
+static void
+bench_draw_once (cairo_surface_t *surface, const BenchPrimitive *primitive,
+                 const EquinoxColors *colors, int state, int width, int height, int variant)
+{
+	WidgetParameters widget;
+	cairo_t *cr;
+
+	bench_init_widget (&widget, colors, state);
+
+	cr = cairo_create (surface);
+	cairo_set_line_width (cr, 1.0);
+	cairo_set_line_cap (cr, CAIRO_LINE_CAP_SQUARE);
+	cairo_set_line_join (cr, CAIRO_LINE_JOIN_MITER);
+
+	primitive->func (cr, colors, &widget, width, height, variant);
+
+	cairo_destroy (cr);
+}
+
+static gboolean first_result = TRUE;
+
+static void
+bench_run_case (const BenchPrimitive *primitive, const EquinoxColors *colors,
+                int state, const BenchSize *size, int variant, gboolean cached, double min_time)
+{
+	cairo_surface_t *surface;
+	GTimer *timer;
+	gulong iterations = 0;
+	gulong batch = 1;
+	gulong i;
+	double elapsed = 0.0;
+	double ns_per_op, ops_per_sec, pixels;
+
+	surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, size->width, size->height);
+
+	/* warm up, also fills the caches for the cached runs */
+	bench_draw_once (surface, primitive, colors, state, size->width, size->height, variant);
+	cairo_surface_flush (surface);
+
+	timer = g_timer_new ();
+	while (elapsed < min_time) {
+		for (i = 0; i < batch; i++)
+			bench_draw_once (surface, primitive, colors, state, size->width, size->height, variant);
+		cairo_surface_flush (surface);
+
+		iterations += batch;
+		elapsed = g_timer_elapsed (timer, NULL);
+		batch *= 2;
+	}
+	g_timer_destroy (timer);
+	cairo_surface_destroy (surface);
+
+	ns_per_op = elapsed * 1e9 / iterations;
+	ops_per_sec = iterations / elapsed;
+	pixels = primitive->fixed_size ? 15 * 15 : (double) size->width * size->height;
+
+	g_print ("%s\n    { \"primitive\": \"%s\", \"width\": %d, \"height\": %d, \"state\": \"%s\", "
+	         "\"variant\": %d, \"cached\": %s, \"iterations\": %lu, "
+	         "\"ns_per_op\": %.1f, \"ops_per_sec\": %.1f, \"pixels_per_sec\": %.1f }",
+	         first_result ? "" : ",",
+	         primitive->name, size->width, size->height, bench_states[state].name,
+	         variant, cached ? "true" : "false", iterations,
+	         ns_per_op, ops_per_sec, ops_per_sec * pixels);
+
+	first_result = FALSE;
+}
+
+/* The engine types are registered on a module that is never unloaded,
+ * so the bench does not depend on an installed engine. */
+typedef GTypeModule      BenchModule;
+typedef GTypeModuleClass BenchModuleClass;
+
+G_DEFINE_TYPE (BenchModule, bench_module, G_TYPE_TYPE_MODULE)
+
+static gboolean
+bench_module_load (GTypeModule *module)
+{
+	return TRUE;
+}
+
+static void
+bench_module_unload (GTypeModule *module)
+{
+}
+
+static void
+bench_module_class_init (BenchModuleClass *klass)
+{
+	klass->load = bench_module_load;
+	klass->unload = bench_module_unload;
+}
+
+static void
+bench_module_init (BenchModule *module)
+{
+}
+
+/* from equinox_theme_main.c */
+void        theme_init            (GTypeModule *module);
+GtkRcStyle *theme_create_rc_style (void);
+
+/* An Equinox style set up the way GTK sets one up from a gtkrc with
+ * animation set to TRUE or FALSE, attached to the root window.  The rc
+ * style lives as long as the style. */
+static GtkStyle *
+bench_create_style (gboolean animation)
+{
+	static GTypeModule *module = NULL;
+	GtkRcStyle *rc_style;
+	GtkStyle *style;
+
+	if (module == NULL) {
+		module = g_object_new (bench_module_get_type (), NULL);
+		g_type_module_use (module);
+		theme_init (module);
+	}
+
+	rc_style = theme_create_rc_style ();
+	EQUINOX_RC_STYLE (rc_style)->animation = animation;
+	EQUINOX_RC_STYLE (rc_style)->flags |= EQX_FLAG_ANIMATION;
+
+	style = GTK_RC_STYLE_GET_CLASS (rc_style)->create_style (rc_style);
+	GTK_STYLE_GET_CLASS (style)->init_from_rc (style, rc_style);
+	g_object_set_data_full (G_OBJECT (style), "equinox-bench-rc-style", rc_style, g_object_unref);
+
+	return gtk_style_attach (style, gdk_get_default_root_window ());
+}
+
+static void
+bench_destroy_style (GtkStyle *style)
+{
+	gtk_style_detach (style);
+	g_object_unref (style);
+}
+
+/* A button box through the style's entry point, the way GTK paints one */
+static void
+bench_paint_button (GtkStyle *style, GdkPixmap *pixmap, GtkWidget *button)
+{
+	gtk_paint_box (style, pixmap, GTK_STATE_NORMAL, GTK_SHADOW_OUT, NULL,
+	               button, "button", 0, 0, 80, 28);
+}
+
+/* mode is "none" for the style without its animation hooks, "off" and
+ * "on" for a style with animation turned off and on */
+static void
+bench_run_animation_mode (const char *mode, GtkStyle *style, GdkPixmap *pixmap,
+                          GtkWidget *button, double min_time, gboolean first)
+{
+	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
+	const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
+	GTimer *timer;
+	gulong iterations = 0;
+	gulong batch = 1;
+	gulong i;
+	double elapsed = 0.0;
+
+	if (strcmp (mode, "none") == 0)
+		equinox_style->animation_hooks = NULL;
+
+	timer = g_timer_new ();
+	while (elapsed < min_time) {
+		for (i = 0; i < batch; i++)
+			bench_paint_button (style, pixmap, button);
+		/* the X server does the rendering */
+		gdk_flush ();
+
+		iterations += batch;
+		elapsed = g_timer_elapsed (timer, NULL);
+		batch *= 2;
+	}
+	g_timer_destroy (timer);
+	equinox_style->animation_hooks = hooks;
+
+	g_print ("%s\n    { \"animation\": \"%s\", \"iterations\": %lu, \"ns_per_draw\": %.1f }",
+	         first ? "" : ",", mode, iterations, elapsed * 1e9 / iterations);
+}
+
+/* Every box the style draws for a button first makes sure the button's
+ * animation signals are connected, so that check is on the draw path of
+ * every button in the application. */
+static void
+bench_run_connections (guint n_buttons, GtkStyle *style, GdkPixmap *pixmap, double min_time, gboolean first)
+{
+	GtkWidget **buttons;
+	GTimer *timer;
+	gulong draws = 0;
+	double connect_time, elapsed = 0.0;
+	guint i;
+
+	buttons = g_new (GtkWidget*, n_buttons);
+	for (i = 0; i < n_buttons; i++)
+		buttons[i] = g_object_ref_sink (gtk_button_new ());
+
+	timer = g_timer_new ();
+
+	/* the first draw of each button connects it */
+	for (i = 0; i < n_buttons; i++)
+		equinox_animation_connect_button (buttons[i]);
+	connect_time = g_timer_elapsed (timer, NULL);
+
+	g_timer_start (timer);
+	while (elapsed < min_time) {
+		for (i = 0; i < n_buttons; i++)
+			bench_paint_button (style, pixmap, buttons[i]);
+		gdk_flush ();
+
+		draws += n_buttons;
+		elapsed = g_timer_elapsed (timer, NULL);
+	}
+	g_timer_destroy (timer);
+
+	g_print ("%s\n    { \"buttons\": %u, \"connect_ns_per_op\": %.1f, \"draws\": %lu, \"ns_per_draw\": %.1f }",
+	         first ? "" : ",", n_buttons, connect_time * 1e9 / n_buttons, draws, elapsed * 1e9 / draws);
+
+	for (i = 0; i < n_buttons; i++) {
+		gtk_widget_destroy (buttons[i]);
+		g_object_unref (buttons[i]);
+	}
+	g_free (buttons);
+
+	equinox_animation_cleanup ();
+}
+
+/* the virtual clock of the replay, stepped by bench_run_replay */
+static gdouble
+bench_replay_clock (gpointer data)
+{
+	return *(const gdouble*) data;
+}
+
+/* Advances the animations n_frames ticks over n_widgets widgets, half
+ * buttons and half progress bars.  The buttons change state every 8th
+ * frame, staggered, so transitions keep starting and restarting while the
+ * progress bars run all the time.  Returns FALSE if a damaged progress
+ * bar was exposed without repainting its stripes, or none ever was. */
+static gboolean
+bench_run_replay (guint n_frames, guint n_widgets)
+{
+	EquinoxAnimationStats before, after;
+	GtkWidget *window, *table;
+	GtkWidget **widgets;
+	gdouble now = 0.0;
+	guint interval = ANIMATION_DELAY;
+	guint64 ns, total_ns = 0, total_pixels = 0;
+	gulong total_dirtied = 0, total_stale = 0;
+	guint frame, i, stale;
+	clock_t start;
+
+	equinox_animation_set_clock (bench_replay_clock, &now);
+	/* the time budget is measured in real time, the limit on running
+	 * animations does not depend on it */
+	equinox_animation_set_limits (ANIMATION_LIMIT, 0);
+
+	/* popups animate at full rate whatever has the focus */
+	window = gtk_window_new (GTK_WINDOW_POPUP);
+	table = gtk_table_new ((n_widgets + 9) / 10, 10, TRUE);
+	gtk_container_add (GTK_CONTAINER (window), table);
+
+	widgets = g_new (GtkWidget*, n_widgets);
+	for (i = 0; i < n_widgets; i++) {
+		if (i % 2) {
+			widgets[i] = gtk_button_new_with_label ("Replay");
+		} else {
+			widgets[i] = gtk_progress_bar_new ();
+			gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (widgets[i]), 0.5);
+		}
+		gtk_widget_set_size_request (widgets[i], 80, 28);
+		gtk_table_attach_defaults (GTK_TABLE (table), widgets[i], i % 10, i % 10 + 1, i / 10, i / 10 + 1);
+	}
+	gtk_widget_show_all (window);
+
+	/* the first expose, and whatever else the window got, before the clock starts */
+	while (gtk_events_pending ())
+		gtk_main_iteration ();
+	gdk_window_process_all_updates ();
+
+	for (i = 0; i < n_widgets; i++) {
+		if (i % 2)
+			equinox_animation_connect_button (widgets[i]);
+		else
+			equinox_animation_progressbar_add (widgets[i]);
+	}
+
+	g_print (",\n  \"replay\": {\n    \"frames\": %u,\n    \"widgets\": %u,\n    \"ticks\": [", n_frames, n_widgets);
+
+	for (frame = 0; frame < n_frames; frame++) {
+		for (i = 1; i < n_widgets; i += 2) {
+			if ((frame + i) % 8 == 0)
+				gtk_widget_set_state (widgets[i], GTK_WIDGET_STATE (widgets[i]) == GTK_STATE_PRELIGHT ?
+				                                  GTK_STATE_NORMAL : GTK_STATE_PRELIGHT);
+		}
+
+		/* a stopped timer still lets the time pass */
+		now += (interval ? interval : ANIMATION_DELAY) / 1000.0;
+
+		equinox_animation_get_stats (&before);
+		start = clock ();
+		interval = equinox_animation_tick ();
+		ns = (guint64) (clock () - start) * 1000000000 / CLOCKS_PER_SEC;
+
+		/* what GDK's redraw idle would do, the expose handlers time it */
+		gdk_window_process_all_updates ();
+		equinox_animation_get_stats (&after);
+
+		/* painting a bar clears its dirty flag, one still set was exposed
+		 * from its old pixmap or not at all */
+		stale = 0;
+		for (i = 0; i < n_widgets; i += 2) {
+			if (GTK_PROGRESS_BAR (widgets[i])->dirty)
+				stale++;
+		}
+
+		g_print ("%s\n      { \"frame\": %u, \"animations\": %u, \"cpu_ns\": %" G_GUINT64_FORMAT ", \"redraw_ns\": %.0f, \"pixels\": %" G_GUINT64_FORMAT ", \"invalidations\": %lu, \"dirtied_bars\": %lu, \"stale_bars\": %u, \"snapped\": %lu, \"next_ms\": %u }",
+		         frame ? "," : "", frame, before.animations,
+		         ns, (after.redraw_time - before.redraw_time) * 1e9, after.pixels - before.pixels, after.invalidations - before.invalidations,
+		         after.dirtied_bars - before.dirtied_bars, stale, after.snapped - before.snapped, interval);
+		total_ns += ns;
+		total_pixels += after.pixels - before.pixels;
+		total_dirtied += after.dirtied_bars - before.dirtied_bars;
+		total_stale += stale;
+	}
+
+	g_print ("\n    ],\n    \"cpu_ns\": %" G_GUINT64_FORMAT ",\n    \"pixels\": %" G_GUINT64_FORMAT ",\n    \"dirtied_bars\": %lu,\n    \"stale_bars\": %lu\n  }",
+	         total_ns, total_pixels, total_dirtied, total_stale);
+
+	gtk_widget_destroy (window);
+	g_free (widgets);
+
+	equinox_animation_cleanup ();
+	equinox_animation_set_clock (NULL, NULL);
+	equinox_animation_set_limits (ANIMATION_LIMIT, ANIMATION_BUDGET);
+
+	if (total_stale > 0)
+		g_printerr ("equinox-bench: %lu progress bar exposes showed stale stripes\n", total_stale);
+	if (total_dirtied == 0)
+		g_printerr ("equinox-bench: no progress bar was marked for a repaint\n");
+
+	return total_stale == 0 && total_dirtied > 0;
+}
+
+/* Whether --filter selects the primitive or section called name */
+static gboolean
+bench_selected (const gchar *name, const gchar *filter)
+{
+	return filter == NULL || strstr (name, filter) != NULL;
+}
+
+int
+main (int argc, char **argv)
+{
+	static double min_time = 0.05;
+	static gchar *filter = NULL;
+	static gboolean no_cache = FALSE;
+	static gint frames = 200;
+	static gint widgets = 50;
+	static GOptionEntry entries[] = {
+		{ "time", 't', 0, G_OPTION_ARG_DOUBLE, &min_time, "Minimum time per case in seconds (default 0.05)", "SECONDS" },
+		{ "filter", 'f', 0, G_OPTION_ARG_STRING, &filter, "Only run primitives and sections whose name contains STRING", "STRING" },
+		{ "no-cache", 0, 0, G_OPTION_ARG_NONE, &no_cache, "Skip the runs with the render caches enabled", NULL },
+		{ "frames", 0, 0, G_OPTION_ARG_INT, &frames, "Ticks of the animation replay (default 200)", "N" },
+		{ "widgets", 0, 0, G_OPTION_ARG_INT, &widgets, "Animated widgets in the replay (default 50)", "M" },
+		{ NULL }
+	};
+	GOptionContext *context;
+	GError *error = NULL;
+	EquinoxColors colors, uncached;
+	guint p, size, state;
+	int variant;
+	static const guint n_buttons[] = { 100, 1000, 10000 };
+	gboolean have_display;
+	gboolean ok = TRUE;
+	GtkStyle *style_off, *style_on;
+	GdkPixmap *pixmap;
+	GtkWidget *button;
+	guint n;
+
+	context = g_option_context_new ("- benchmark the Equinox drawing primitives");
+	g_option_context_add_main_entries (context, entries, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("%s\n", error->message);
+		g_error_free (error);
+		return 1;
+	}
+	g_option_context_free (context);
+
+	/* the drawing primitives do not need a display, buttons do */
+	have_display = gtk_init_check (&argc, &argv);
+
+	g_print ("{\n  \"engine\": \"equinox\",\n  \"min_time\": %g,\n  \"results\": [", min_time);
+
+	for (p = 0; p < G_N_ELEMENTS (bench_primitives); p++) {
+		const BenchPrimitive *primitive = &bench_primitives[p];
+
+		if (!bench_selected (primitive->name, filter))
+			continue;
+
+		for (variant = 0; variant < primitive->variants; variant++) {
+			/* a zero fingerprint makes every cache step aside */
+			bench_init_colors (&colors, variant);
+			uncached = colors;
+			uncached.fingerprint = 0;
+
+			for (size = 0; size < G_N_ELEMENTS (bench_sizes); size++) {
+				if (primitive->fixed_size && size > 0)
+					break;
+
+				for (state = 0; state < G_N_ELEMENTS (bench_states); state++) {
+					bench_run_case (primitive, &uncached, state, &bench_sizes[size], variant, FALSE, min_time);
+					if (!no_cache)
+						bench_run_case (primitive, &colors, state, &bench_sizes[size], variant, TRUE, min_time);
+				}
+			}
+		}
+	}
+
+	g_print ("\n  ]");
+
+	if (bench_selected ("button", filter)) {
+		if (have_display) {
+			style_off = bench_create_style (FALSE);
+			style_on = bench_create_style (TRUE);
+			pixmap = gdk_pixmap_new (gdk_get_default_root_window (), 80, 28, -1);
+			button = g_object_ref_sink (gtk_button_new ());
+
+			g_print (",\n  \"animation\": [");
+			bench_run_animation_mode ("none", style_on, pixmap, button, min_time, TRUE);
+			bench_run_animation_mode ("off", style_off, pixmap, button, min_time, FALSE);
+			bench_run_animation_mode ("on", style_on, pixmap, button, min_time, FALSE);
+			g_print ("\n  ]");
+
+			gtk_widget_destroy (button);
+			g_object_unref (button);
+
+			g_print (",\n  \"connections\": [");
+			for (n = 0; n < G_N_ELEMENTS (n_buttons); n++)
+				bench_run_connections (n_buttons[n], style_on, pixmap, min_time, n == 0);
+			g_print ("\n  ]");
+
+			g_object_unref (pixmap);
+			bench_destroy_style (style_on);
+			bench_destroy_style (style_off);
+		} else {
+			g_printerr ("equinox-bench: no display, skipping the button runs\n");
+		}
+	}
+
+	if (frames > 0 && widgets > 0 && bench_selected ("replay", filter)) {
+		if (have_display)
+			ok = bench_run_replay (frames, widgets);
+		else
+			g_printerr ("equinox-bench: no display, skipping the animation replay\n");
+	}
+
+	g_print ("\n}\n");
+
+	equinox_cache_cleanup ();
+
+	return ok ? 0 : 1;
+}
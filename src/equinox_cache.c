@@ -0,0 +1,654 @@
+/* Equinox Engine
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Render caches: stretchable widget chrome, gradient patterns, progress bar
+ * stripe tiles and the indicator atlas.
+ *
+ * The surface cache holds the stretchable widget chrome (buttons, entries
+ * and scrollbar sliders).  These elements only vary along their long axis in the rounded caps, so
+ * each one is rasterized once at its real height and a minimal width
+ * (two caps plus a one pixel wide middle column) and then blitted with the
+ * middle column stretched to the requested width.  The gradients all run
+ * along the short axis, which is why the height is part of the key instead
+ * of being stretched as well.
+ *
+ * Indicators never stretch at all, and there are only a handful of
+ * variants of each, so they are packed into one atlas surface per palette
+ * and copied out of it.  Cells are handed out in order and never freed
+ * individually.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "equinox_cache.h"
+#include "support.h"
+
+static GHashTable *surface_cache = NULL;
+static EquinoxCacheStats cache_stats;
+
+typedef struct {
+	cairo_surface_t *surface;
+	GHashTable *cells;	/* EquinoxAtlasKey -> cell index + 1 */
+	guint used;
+} EquinoxAtlas;
+
+typedef struct {
+	guint32 palette;
+	guint16 height;
+	guint16 style;
+} EquinoxStripeKey;
+
+/* EquinoxStripeKey -> cairo_pattern_t */
+static GHashTable *stripe_cache = NULL;
+
+/* Only the stops; the geometry goes into the pattern matrix */
+typedef struct {
+	int n_stops;
+	EquinoxGradientStop stops[EQX_GRADIENT_MAX_STOPS];
+} EquinoxGradientKey;
+
+/* EquinoxGradientKey -> cairo_pattern_t */
+static GHashTable *gradient_cache = NULL;
+
+/* palette fingerprint -> EquinoxAtlas */
+static GHashTable *atlases = NULL;
+static EquinoxAtlasStats atlas_stats;
+
+static guint32
+fnv1a (const guchar *data, gsize len, guint32 hash)
+{
+	gsize i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static guint
+cache_key_hash (gconstpointer key)
+{
+	return fnv1a (key, sizeof (EquinoxCacheKey), 2166136261u);
+}
+
+static gboolean
+cache_key_equal (gconstpointer a, gconstpointer b)
+{
+	return memcmp (a, b, sizeof (EquinoxCacheKey)) == 0;
+}
+
+/* The fingerprint covers every colour of the palette, so two styles with the
+ * same colours share their cached surfaces.  Zero means "not computed", in
+ * which case nothing drawn with that palette gets cached. */
+guint32
+equinox_cache_palette_fingerprint (const EquinoxColors *colors)
+{
+	guint32 hash;
+
+	hash = fnv1a ((const guchar *) colors, G_STRUCT_OFFSET (EquinoxColors, fingerprint), 2166136261u);
+
+	return hash ? hash : 1;
+}
+
+/* Width of the caps on either side of the stretched column.  It has to hold
+ * the widest corner the draw functions produce (the focus ring uses
+ * curvature + 2) plus the antialiasing around it. */
+int
+equinox_cache_edge_size (const WidgetParameters *widget)
+{
+	return (int) ceil (MAX (widget->curvature, 0.0)) + 4;
+}
+
+/* uses_parentbg is TRUE if the element's drawing, for these parameters,
+ * reads equinox_params_parentbg */
+gboolean
+equinox_cache_key_init (EquinoxCacheKey        *key,
+                        EquinoxCacheElement     element,
+                        const EquinoxColors    *colors,
+                        const WidgetParameters *widget,
+                        int width, int height,
+                        guint8 variant, guint8 subvariant,
+                        gboolean uses_parentbg)
+{
+	int edge = equinox_cache_edge_size (widget);
+
+	if (colors->fingerprint == 0 || height <= 0 || height > EQX_CACHE_MAX_HEIGHT || width < 2 * edge + 1) {
+		cache_stats.bypassed++;
+		return FALSE;
+	}
+
+	memset (key, 0, sizeof (EquinoxCacheKey));
+
+	key->palette = colors->fingerprint;
+	key->element = element;
+	key->state_type = widget->state_type;
+	key->flags = (widget->active ? 1 : 0) |
+	             (widget->prelight ? 2 : 0) |
+	             (widget->disabled ? 4 : 0) |
+	             (widget->focus ? 8 : 0) |
+	             (widget->is_default ? 16 : 0);
+	key->corners = widget->corners;
+	key->variant = variant;
+	key->subvariant = subvariant;
+	key->height = height;
+	key->edge = edge;
+	key->curvature = widget->curvature;
+
+	/* looked up only if the drawing reads it, the rest stay shared
+	 * between parents and the lookup stays lazy */
+	if (uses_parentbg)
+		key->parentbg = *equinox_params_parentbg (widget);
+
+	/* Transitions are drawn as a cross-fade of two settled entries, so
+	 * there are no keys for the frames in between */
+	return TRUE;
+}
+
+cairo_surface_t *
+equinox_cache_lookup (const EquinoxCacheKey *key)
+{
+	cairo_surface_t *surface = NULL;
+
+	if (surface_cache)
+		surface = g_hash_table_lookup (surface_cache, key);
+
+	if (surface)
+		cache_stats.hits++;
+	else
+		cache_stats.misses++;
+
+	return surface;
+}
+
+/* Returns a context set up like equinox_begin_paint for rendering the
+ * minimal-width version of the element described by key. */
+cairo_t *
+equinox_cache_begin_render (const EquinoxCacheKey *key, cairo_surface_t **surface)
+{
+	cairo_t *cr;
+
+	*surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 2 * key->edge + 1, key->height);
+
+	cr = cairo_create (*surface);
+	cairo_set_line_width (cr, 1.0);
+	cairo_set_line_cap (cr, CAIRO_LINE_CAP_SQUARE);
+	cairo_set_line_join (cr, CAIRO_LINE_JOIN_MITER);
+
+	return cr;
+}
+
+/* Takes over the reference to surface. */
+void
+equinox_cache_insert (const EquinoxCacheKey *key, cairo_surface_t *surface)
+{
+	if (surface_cache == NULL)
+		surface_cache = g_hash_table_new_full (cache_key_hash, cache_key_equal,
+		                                       g_free, (GDestroyNotify) cairo_surface_destroy);
+
+	/* Themes only produce a few dozen distinct elements; running into the
+	 * limit means the palette or sizes keep changing, so start over. */
+	if (g_hash_table_size (surface_cache) >= EQX_CACHE_MAX_ENTRIES) {
+		cache_stats.evictions += g_hash_table_size (surface_cache);
+		g_hash_table_remove_all (surface_cache);
+	}
+
+	g_hash_table_insert (surface_cache, g_memdup (key, sizeof (EquinoxCacheKey)), surface);
+}
+
+/* Draws surface at x, y stretched to width.  The caps of edge pixels are
+ * copied as they are and the column(s) between them are repeated. */
+void
+equinox_cache_blit (cairo_t *cr, cairo_surface_t *surface, int edge,
+                    double x, double y, int width, int height)
+{
+	cairo_pattern_t *pattern;
+	cairo_matrix_t matrix;
+	int src_width = cairo_image_surface_get_width (surface);
+	int middle = src_width - 2 * edge;
+	int stretch = width - 2 * edge;
+
+	cairo_save (cr);
+	cairo_translate (cr, x, y);
+
+	/* left cap */
+	cairo_set_source_surface (cr, surface, 0, 0);
+	cairo_rectangle (cr, 0, 0, edge, height);
+	cairo_fill (cr);
+
+	/* right cap */
+	cairo_set_source_surface (cr, surface, width - src_width, 0);
+	cairo_rectangle (cr, width - edge, 0, edge, height);
+	cairo_fill (cr);
+
+	/* stretched middle */
+	if (stretch > 0 && middle > 0) {
+		pattern = cairo_pattern_create_for_surface (surface);
+		cairo_matrix_init_translate (&matrix, edge, 0);
+		cairo_matrix_scale (&matrix, (double) middle / stretch, 1.0);
+		cairo_matrix_translate (&matrix, -edge, 0);
+		cairo_pattern_set_matrix (pattern, &matrix);
+		cairo_pattern_set_extend (pattern, CAIRO_EXTEND_PAD);
+		cairo_pattern_set_filter (pattern, CAIRO_FILTER_NEAREST);
+
+		cairo_set_source (cr, pattern);
+		cairo_rectangle (cr, edge, 0, stretch, height);
+		cairo_fill (cr);
+		cairo_pattern_destroy (pattern);
+	}
+
+	cairo_restore (cr);
+}
+
+static void
+stripe_key_init (EquinoxStripeKey *key, const EquinoxColors *colors, int height, int style)
+{
+	memset (key, 0, sizeof (EquinoxStripeKey));
+	key->palette = colors->fingerprint;
+	key->height = height;
+	key->style = style;
+}
+
+static guint
+stripe_key_hash (gconstpointer key)
+{
+	return fnv1a (key, sizeof (EquinoxStripeKey), 2166136261u);
+}
+
+static gboolean
+stripe_key_equal (gconstpointer a, gconstpointer b)
+{
+	return memcmp (a, b, sizeof (EquinoxStripeKey)) == 0;
+}
+
+/* Returns a borrowed pattern, or NULL if the tile still has to be made. */
+cairo_pattern_t *
+equinox_cache_lookup_stripes (const EquinoxColors *colors, int height, int style)
+{
+	EquinoxStripeKey key;
+	cairo_pattern_t *pattern = NULL;
+
+	if (colors->fingerprint == 0 || height > G_MAXUINT16) {
+		cache_stats.bypassed++;
+		return NULL;
+	}
+
+	stripe_key_init (&key, colors, height, style);
+	if (stripe_cache)
+		pattern = g_hash_table_lookup (stripe_cache, &key);
+
+	if (pattern)
+		cache_stats.stripe_hits++;
+	else
+		cache_stats.stripe_misses++;
+
+	return pattern;
+}
+
+void
+equinox_cache_insert_stripes (const EquinoxColors *colors, int height, int style,
+                              cairo_pattern_t *pattern)
+{
+	EquinoxStripeKey key;
+
+	if (colors->fingerprint == 0 || height > G_MAXUINT16)
+		return;
+
+	if (stripe_cache == NULL)
+		stripe_cache = g_hash_table_new_full (stripe_key_hash, stripe_key_equal,
+		                                      g_free, (GDestroyNotify) cairo_pattern_destroy);
+
+	if (g_hash_table_size (stripe_cache) >= EQX_CACHE_MAX_ENTRIES) {
+		cache_stats.evictions += g_hash_table_size (stripe_cache);
+		g_hash_table_remove_all (stripe_cache);
+	}
+
+	stripe_key_init (&key, colors, height, style);
+	g_hash_table_insert (stripe_cache, g_memdup (&key, sizeof (EquinoxStripeKey)),
+	                     cairo_pattern_reference (pattern));
+}
+
+void
+equinox_gradient_init (EquinoxGradient *gradient, double x0, double y0, double x1, double y1)
+{
+	gradient->x0 = x0;
+	gradient->y0 = y0;
+	gradient->x1 = x1;
+	gradient->y1 = y1;
+	gradient->n_stops = 0;
+}
+
+void
+equinox_gradient_add_rgba (EquinoxGradient *gradient, double offset, const EquinoxRGB *color, double alpha)
+{
+	EquinoxGradientStop *stop;
+
+	g_return_if_fail (gradient->n_stops < EQX_GRADIENT_MAX_STOPS);
+
+	stop = &gradient->stops[gradient->n_stops++];
+	stop->offset = offset;
+	stop->r = color->r;
+	stop->g = color->g;
+	stop->b = color->b;
+	stop->a = alpha;
+}
+
+void
+equinox_gradient_add_rgb (EquinoxGradient *gradient, double offset, const EquinoxRGB *color)
+{
+	equinox_gradient_add_rgba (gradient, offset, color, 1.0);
+}
+
+static guint
+gradient_key_hash (gconstpointer key)
+{
+	return fnv1a (key, sizeof (EquinoxGradientKey), 2166136261u);
+}
+
+static gboolean
+gradient_key_equal (gconstpointer a, gconstpointer b)
+{
+	return memcmp (a, b, sizeof (EquinoxGradientKey)) == 0;
+}
+
+static void
+gradient_add_stops (cairo_pattern_t *pattern, const EquinoxGradientStop *stops, int n_stops)
+{
+	int i;
+
+	for (i = 0; i < n_stops; i++)
+		cairo_pattern_add_color_stop_rgba (pattern, stops[i].offset,
+		                                   stops[i].r, stops[i].g, stops[i].b, stops[i].a);
+}
+
+/* Cached patterns run from 0 to EQX_GRADIENT_LENGTH along x.  A length in
+ * the range of real widgets keeps the matrix well within what pixman's
+ * fixed point transforms can represent. */
+#define EQX_GRADIENT_LENGTH 256.0
+
+cairo_pattern_t *
+equinox_gradient_get_pattern (const EquinoxGradient *gradient)
+{
+	EquinoxGradientKey key;
+	cairo_pattern_t *pattern = NULL;
+	cairo_matrix_t matrix;
+	double dx = gradient->x1 - gradient->x0;
+	double dy = gradient->y1 - gradient->y0;
+	double scale = dx * dx + dy * dy;
+
+	if (scale == 0.0) {
+		cache_stats.gradient_uncached++;
+		pattern = cairo_pattern_create_linear (gradient->x0, gradient->y0, gradient->x1, gradient->y1);
+		gradient_add_stops (pattern, gradient->stops, gradient->n_stops);
+		return pattern;
+	}
+
+	memset (&key, 0, sizeof (EquinoxGradientKey));
+	key.n_stops = gradient->n_stops;
+	memcpy (key.stops, gradient->stops, gradient->n_stops * sizeof (EquinoxGradientStop));
+
+	if (gradient_cache)
+		pattern = g_hash_table_lookup (gradient_cache, &key);
+
+	if (pattern) {
+		cache_stats.gradient_hits++;
+	} else {
+		cache_stats.gradient_misses++;
+
+		if (gradient_cache == NULL)
+			gradient_cache = g_hash_table_new_full (gradient_key_hash, gradient_key_equal,
+			                                        g_free, (GDestroyNotify) cairo_pattern_destroy);
+
+		/* Patterns handed out stay valid through their own reference */
+		if (g_hash_table_size (gradient_cache) >= EQX_GRADIENT_MAX_ENTRIES) {
+			cache_stats.evictions += g_hash_table_size (gradient_cache);
+			g_hash_table_remove_all (gradient_cache);
+		}
+
+		pattern = cairo_pattern_create_linear (0, 0, EQX_GRADIENT_LENGTH, 0);
+		gradient_add_stops (pattern, key.stops, key.n_stops);
+		g_hash_table_insert (gradient_cache, g_memdup (&key, sizeof (EquinoxGradientKey)), pattern);
+	}
+
+	/* Map user space onto the cached pattern: the gradient's start goes to
+	 * the origin and its end to (EQX_GRADIENT_LENGTH, 0). */
+	scale = EQX_GRADIENT_LENGTH / scale;
+	cairo_matrix_init (&matrix,
+	                   dx * scale, -dy * scale,
+	                   dy * scale, dx * scale,
+	                   -(dx * gradient->x0 + dy * gradient->y0) * scale,
+	                   (dy * gradient->x0 - dx * gradient->y0) * scale);
+	cairo_pattern_set_matrix (pattern, &matrix);
+
+	return cairo_pattern_reference (pattern);
+}
+
+static guint
+atlas_key_hash (gconstpointer key)
+{
+	return fnv1a (key, sizeof (EquinoxAtlasKey), 2166136261u);
+}
+
+static gboolean
+atlas_key_equal (gconstpointer a, gconstpointer b)
+{
+	return memcmp (a, b, sizeof (EquinoxAtlasKey)) == 0;
+}
+
+static void
+atlas_free (EquinoxAtlas *atlas)
+{
+	cairo_surface_destroy (atlas->surface);
+	g_hash_table_destroy (atlas->cells);
+	g_free (atlas);
+}
+
+static void
+atlas_cell_sprite (EquinoxAtlas *atlas, guint cell, EquinoxAtlasSprite *sprite)
+{
+	sprite->surface = atlas->surface;
+	sprite->x = (cell % EQX_ATLAS_COLUMNS) * EQX_ATLAS_CELL + EQX_ATLAS_PAD;
+	sprite->y = (cell / EQX_ATLAS_COLUMNS) * EQX_ATLAS_CELL + EQX_ATLAS_PAD;
+}
+
+gboolean
+equinox_atlas_key_init (EquinoxAtlasKey     *key,
+                        EquinoxAtlasGlyph    glyph,
+                        const EquinoxColors *colors,
+                        int state_type, int variant)
+{
+	if (colors->fingerprint == 0) {
+		atlas_stats.bypassed++;
+		return FALSE;
+	}
+
+	memset (key, 0, sizeof (EquinoxAtlasKey));
+
+	key->palette = colors->fingerprint;
+	key->glyph = glyph;
+	key->state_type = state_type;
+	key->variant = variant;
+
+	return TRUE;
+}
+
+gboolean
+equinox_atlas_lookup (const EquinoxAtlasKey *key, EquinoxAtlasSprite *sprite)
+{
+	EquinoxAtlas *atlas = NULL;
+	guint cell = 0;
+
+	if (atlases)
+		atlas = g_hash_table_lookup (atlases, GUINT_TO_POINTER (key->palette));
+	if (atlas)
+		cell = GPOINTER_TO_UINT (g_hash_table_lookup (atlas->cells, key));
+
+	if (cell == 0) {
+		atlas_stats.misses++;
+		return FALSE;
+	}
+
+	atlas_stats.hits++;
+	atlas_cell_sprite (atlas, cell - 1, sprite);
+
+	return TRUE;
+}
+
+/* Reserves a cell for key and returns a context clipped to it, set up like
+ * equinox_begin_paint.  The glyph has to be drawn at sprite->x, sprite->y in
+ * absolute coordinates; the context's matrix is the identity. */
+cairo_t *
+equinox_atlas_begin_render (const EquinoxAtlasKey *key, EquinoxAtlasSprite *sprite)
+{
+	EquinoxAtlas *atlas = NULL;
+	cairo_t *cr;
+	guint cell;
+
+	if (atlases == NULL)
+		atlases = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+		                                 NULL, (GDestroyNotify) atlas_free);
+	else
+		atlas = g_hash_table_lookup (atlases, GUINT_TO_POINTER (key->palette));
+
+	if (atlas == NULL) {
+		atlas = g_new0 (EquinoxAtlas, 1);
+		atlas->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+		                                             EQX_ATLAS_COLUMNS * EQX_ATLAS_CELL,
+		                                             EQX_ATLAS_ROWS * EQX_ATLAS_CELL);
+		atlas->cells = g_hash_table_new_full (atlas_key_hash, atlas_key_equal, g_free, NULL);
+		g_hash_table_insert (atlases, GUINT_TO_POINTER (key->palette), atlas);
+	}
+
+	/* Like the surface cache, a full atlas means some input keeps
+	 * changing (usually the parent background), so start over. */
+	if (atlas->used >= EQX_ATLAS_COLUMNS * EQX_ATLAS_ROWS) {
+		atlas_stats.resets++;
+		g_hash_table_remove_all (atlas->cells);
+		atlas->used = 0;
+
+		cr = cairo_create (atlas->surface);
+		cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+		cairo_paint (cr);
+		cairo_destroy (cr);
+	}
+
+	cell = atlas->used++;
+	g_hash_table_insert (atlas->cells, g_memdup (key, sizeof (EquinoxAtlasKey)), GUINT_TO_POINTER (cell + 1));
+	atlas_cell_sprite (atlas, cell, sprite);
+
+	cr = cairo_create (atlas->surface);
+	cairo_rectangle (cr, sprite->x - EQX_ATLAS_PAD, sprite->y - EQX_ATLAS_PAD, EQX_ATLAS_CELL, EQX_ATLAS_CELL);
+	cairo_clip (cr);
+	cairo_set_line_width (cr, 1.0);
+	cairo_set_line_cap (cr, CAIRO_LINE_CAP_SQUARE);
+	cairo_set_line_join (cr, CAIRO_LINE_JOIN_MITER);
+
+	return cr;
+}
+
+/* Draws the sprite with its origin at x, y. */
+void
+equinox_atlas_blit (cairo_t *cr, const EquinoxAtlasSprite *sprite, int x, int y)
+{
+	cairo_save (cr);
+	cairo_set_source_surface (cr, sprite->surface, x - sprite->x, y - sprite->y);
+	cairo_rectangle (cr, x - EQX_ATLAS_PAD, y - EQX_ATLAS_PAD, EQX_ATLAS_CELL, EQX_ATLAS_CELL);
+	cairo_fill (cr);
+	cairo_restore (cr);
+}
+
+void
+equinox_atlas_get_stats (EquinoxAtlasStats *stats)
+{
+	GHashTableIter iter;
+	EquinoxAtlas *atlas;
+
+	*stats = atlas_stats;
+	stats->atlases = 0;
+	stats->cells = 0;
+
+	if (atlases == NULL)
+		return;
+
+	g_hash_table_iter_init (&iter, atlases);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &atlas)) {
+		stats->atlases++;
+		stats->cells += atlas->used;
+	}
+}
+
+void
+equinox_cache_get_stats (EquinoxCacheStats *stats)
+{
+	*stats = cache_stats;
+	stats->entries = surface_cache ? g_hash_table_size (surface_cache) : 0;
+	stats->stripe_entries = stripe_cache ? g_hash_table_size (stripe_cache) : 0;
+	stats->gradient_entries = gradient_cache ? g_hash_table_size (gradient_cache) : 0;
+}
+
+void
+equinox_cache_print_stats (void)
+{
+	EquinoxCacheStats stats;
+	EquinoxAtlasStats atlas;
+	gulong lookups;
+
+	equinox_cache_get_stats (&stats);
+	lookups = stats.hits + stats.misses;
+
+	g_printerr ("equinox: surface cache: %lu hits, %lu misses (%.1f%% hit rate), %lu bypassed, %lu evicted, %u cached\n",
+	            stats.hits, stats.misses, lookups ? 100.0 * stats.hits / lookups : 0.0,
+	            stats.bypassed, stats.evictions, stats.entries);
+	g_printerr ("equinox: stripe tiles: %lu hits, %lu misses, %u cached\n",
+	            stats.stripe_hits, stats.stripe_misses, stats.stripe_entries);
+	g_printerr ("equinox: gradients: %lu hits, %lu misses, %lu uncached, %u cached\n",
+	            stats.gradient_hits, stats.gradient_misses, stats.gradient_uncached, stats.gradient_entries);
+
+	equinox_atlas_get_stats (&atlas);
+	lookups = atlas.hits + atlas.misses;
+
+	g_printerr ("equinox: indicator atlas: %lu hits, %lu misses (%.1f%% hit rate), %lu bypassed, %lu resets, %u cells in %u atlases\n",
+	            atlas.hits, atlas.misses, lookups ? 100.0 * atlas.hits / lookups : 0.0,
+	            atlas.bypassed, atlas.resets, atlas.cells, atlas.atlases);
+}
+
+void
+equinox_cache_cleanup (void)
+{
+	if (surface_cache != NULL) {
+		g_hash_table_destroy (surface_cache);
+		surface_cache = NULL;
+	}
+
+	if (gradient_cache != NULL) {
+		g_hash_table_destroy (gradient_cache);
+		gradient_cache = NULL;
+	}
+
+	if (stripe_cache != NULL) {
+		g_hash_table_destroy (stripe_cache);
+		stripe_cache = NULL;
+	}
+
+	if (atlases != NULL) {
+		g_hash_table_destroy (atlases);
+		atlases = NULL;
+	}
+}
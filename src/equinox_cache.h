@@ -0,0 +1,185 @@
+/* Equinox Engine
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef EQUINOX_CACHE_H
+#define EQUINOX_CACHE_H
+
+#include <glib.h>
+#include <cairo.h>
+
+#include "equinox_types.h"
+
+/* Elements larger than this along their fixed axis are drawn directly */
+#define EQX_CACHE_MAX_HEIGHT 96
+#define EQX_CACHE_MAX_ENTRIES 256
+
+typedef enum {
+	EQX_CACHE_BUTTON = 1,
+	EQX_CACHE_ENTRY,
+	EQX_CACHE_SCROLLBAR_SLIDER,
+	EQX_CACHE_MENUITEM
+} EquinoxCacheElement;
+
+/* Everything a cached element's pixels depend on.  Keys are compared
+ * bytewise, so they must always be built with equinox_cache_key_init. */
+typedef struct {
+	guint32 palette;
+	guint8  element;
+	guint8  state_type;
+	guint8  flags;
+	guint8  corners;
+	guint8  variant;
+	guint8  subvariant;
+	guint16 height;
+	guint16 edge;
+	gdouble curvature;
+	EquinoxRGB parentbg;	/* zero unless the element draws with it */
+} EquinoxCacheKey;
+
+typedef struct {
+	gulong hits;
+	gulong misses;
+	gulong bypassed;
+	gulong evictions;
+	guint  entries;
+	gulong stripe_hits;
+	gulong stripe_misses;
+	guint  stripe_entries;
+	gulong gradient_hits;
+	gulong gradient_misses;
+	gulong gradient_uncached;
+	guint  gradient_entries;
+} EquinoxCacheStats;
+
+G_GNUC_INTERNAL guint32  equinox_cache_palette_fingerprint (const EquinoxColors *colors);
+
+G_GNUC_INTERNAL int      equinox_cache_edge_size (const WidgetParameters *widget);
+
+G_GNUC_INTERNAL gboolean equinox_cache_key_init (EquinoxCacheKey        *key,
+                                                 EquinoxCacheElement     element,
+                                                 const EquinoxColors    *colors,
+                                                 const WidgetParameters *widget,
+                                                 int width, int height,
+                                                 guint8 variant, guint8 subvariant,
+                                                 gboolean uses_parentbg);
+
+G_GNUC_INTERNAL cairo_surface_t *equinox_cache_lookup (const EquinoxCacheKey *key);
+G_GNUC_INTERNAL cairo_t *equinox_cache_begin_render (const EquinoxCacheKey *key, cairo_surface_t **surface);
+G_GNUC_INTERNAL void     equinox_cache_insert (const EquinoxCacheKey *key, cairo_surface_t *surface);
+
+G_GNUC_INTERNAL void     equinox_cache_blit (cairo_t *cr, cairo_surface_t *surface, int edge,
+                                             double x, double y, int width, int height);
+
+/* Linear gradients.  The stops are collected in an EquinoxGradient on the
+ * stack; equinox_gradient_get_pattern then hands out a shared pattern for
+ * those stops, mapped onto the gradient's points with the pattern matrix.
+ * The returned reference belongs to the caller, and the matrix is only
+ * valid until the next call, so use the pattern right away. */
+#define EQX_GRADIENT_MAX_STOPS   8
+#define EQX_GRADIENT_MAX_ENTRIES 512
+
+typedef struct {
+	double offset;
+	double r, g, b, a;
+} EquinoxGradientStop;
+
+typedef struct {
+	double x0, y0, x1, y1;
+	int n_stops;
+	EquinoxGradientStop stops[EQX_GRADIENT_MAX_STOPS];
+} EquinoxGradient;
+
+G_GNUC_INTERNAL void     equinox_gradient_init (EquinoxGradient *gradient,
+                                                double x0, double y0, double x1, double y1);
+G_GNUC_INTERNAL void     equinox_gradient_add_rgb (EquinoxGradient *gradient, double offset, const EquinoxRGB *color);
+G_GNUC_INTERNAL void     equinox_gradient_add_rgba (EquinoxGradient *gradient, double offset, const EquinoxRGB *color, double alpha);
+G_GNUC_INTERNAL cairo_pattern_t *equinox_gradient_get_pattern (const EquinoxGradient *gradient);
+
+/* Indicator atlas: fixed-size glyphs (check and radio indicators, arrows,
+ * expanders, handle dots) rasterized once into a shared per-palette surface.
+ * Each glyph gets a CELL sized cell and is drawn with its origin PAD pixels
+ * inside it, so it may reach up to PAD pixels above and left of the origin. */
+#define EQX_ATLAS_CELL    24
+#define EQX_ATLAS_PAD     6
+#define EQX_ATLAS_COLUMNS 16
+#define EQX_ATLAS_ROWS    8
+
+typedef enum {
+	EQX_ATLAS_CHECK = 1,
+	EQX_ATLAS_RADIO,
+	EQX_ATLAS_MENU_CHECK,
+	EQX_ATLAS_MENU_RADIO,
+	EQX_ATLAS_CELL_CHECK,
+	EQX_ATLAS_CELL_RADIO,
+	EQX_ATLAS_ARROW,
+	EQX_ATLAS_EXPANDER,
+	EQX_ATLAS_INSET_CIRCLE
+} EquinoxAtlasGlyph;
+
+/* Compared bytewise like EquinoxCacheKey; colours the glyph reads from
+ * outside the palette (e.g. the parent background) go into color/color2. */
+typedef struct {
+	guint32 palette;
+	guint8  glyph;
+	guint8  state_type;
+	guint8  flags;
+	guint8  corners;
+	guint8  variant;
+	guint8  direction;
+	guint16 size;
+	EquinoxRGB color;
+	EquinoxRGB color2;
+} EquinoxAtlasKey;
+
+/* x, y is the glyph origin inside surface */
+typedef struct {
+	cairo_surface_t *surface;
+	int x;
+	int y;
+} EquinoxAtlasSprite;
+
+typedef struct {
+	gulong hits;
+	gulong misses;
+	gulong bypassed;
+	gulong resets;
+	guint  atlases;
+	guint  cells;
+} EquinoxAtlasStats;
+
+G_GNUC_INTERNAL gboolean equinox_atlas_key_init (EquinoxAtlasKey     *key,
+                                                 EquinoxAtlasGlyph    glyph,
+                                                 const EquinoxColors *colors,
+                                                 int state_type, int variant);
+
+G_GNUC_INTERNAL gboolean equinox_atlas_lookup (const EquinoxAtlasKey *key, EquinoxAtlasSprite *sprite);
+G_GNUC_INTERNAL cairo_t *equinox_atlas_begin_render (const EquinoxAtlasKey *key, EquinoxAtlasSprite *sprite);
+G_GNUC_INTERNAL void     equinox_atlas_blit (cairo_t *cr, const EquinoxAtlasSprite *sprite, int x, int y);
+G_GNUC_INTERNAL void     equinox_atlas_get_stats (EquinoxAtlasStats *stats);
+
+/* Progress bar stripe tiles, one repeating pattern per palette, height and
+ * progress bar style.  insert takes its own reference. */
+G_GNUC_INTERNAL cairo_pattern_t *equinox_cache_lookup_stripes (const EquinoxColors *colors, int height, int style);
+G_GNUC_INTERNAL void     equinox_cache_insert_stripes (const EquinoxColors *colors, int height, int style,
+                                                       cairo_pattern_t *pattern);
+
+G_GNUC_INTERNAL void     equinox_cache_get_stats (EquinoxCacheStats *stats);
+G_GNUC_INTERNAL void     equinox_cache_print_stats (void);
+G_GNUC_INTERNAL void     equinox_cache_cleanup (void);
+
+#endif /* EQUINOX_CACHE_H */
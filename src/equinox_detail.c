@@ -0,0 +1,195 @@
+/* Equinox Engine
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Maps the detail strings GTK+ passes to the style functions to an
+ * EquinoxDetail, so the entry points dispatch on integers instead of
+ * running through chains of strcmp.
+ *
+ * The exact matches go through a perfect hash over the first, second and
+ * last character and the length: every known detail has its own slot, so
+ * a lookup costs one hash and a single strcmp to confirm.  The slot table
+ * is built from detail_names on first use; adding a name that collides
+ * triggers a warning and needs new multipliers in detail_hash.
+ */
+
+#include <string.h>
+
+#include "equinox_detail.h"
+
+#define DETAIL_SLOTS 128
+
+static const gchar *detail_names[EQX_DETAIL_LAST] = {
+	[EQX_DETAIL_NONE] = NULL,
+	[EQX_DETAIL_UNKNOWN] = NULL,
+	[EQX_DETAIL_ACCELLABEL] = "accellabel",
+	[EQX_DETAIL_ARROW] = "arrow",
+	[EQX_DETAIL_BAR] = "bar",
+	[EQX_DETAIL_BUTTON] = "button",
+	[EQX_DETAIL_BUTTONDEFAULT] = "buttondefault",
+	[EQX_DETAIL_CELLCHECK] = "cellcheck",
+	[EQX_DETAIL_CELLRADIO] = "cellradio",
+	[EQX_DETAIL_CELLRENDERERTEXT] = "cellrenderertext",
+	[EQX_DETAIL_CHECKBUTTON] = "checkbutton",
+	[EQX_DETAIL_DOCKITEM_BIN] = "dockitem_bin",
+	[EQX_DETAIL_ENTRY] = "entry",
+	[EQX_DETAIL_EXPANDER] = "expander",
+	[EQX_DETAIL_FRAME] = "frame",
+	[EQX_DETAIL_HANDLEBOX] = "handlebox",
+	[EQX_DETAIL_HANDLEBOX_BIN] = "handlebox_bin",
+	[EQX_DETAIL_HSCALE] = "hscale",
+	[EQX_DETAIL_HSCROLLBAR] = "hscrollbar",
+	[EQX_DETAIL_MENU] = "menu",
+	[EQX_DETAIL_MENUBAR] = "menubar",
+	[EQX_DETAIL_MENUITEM] = "menuitem",
+	[EQX_DETAIL_NOTEBOOK] = "notebook",
+	[EQX_DETAIL_OPTIONMENU] = "optionmenu",
+	[EQX_DETAIL_PAGER] = "pager",
+	[EQX_DETAIL_PAGER_FRAME] = "pager-frame",
+	[EQX_DETAIL_PANED] = "paned",
+	[EQX_DETAIL_SCROLLED_WINDOW] = "scrolled_window",
+	[EQX_DETAIL_SLIDER] = "slider",
+	[EQX_DETAIL_SPINBUTTON] = "spinbutton",
+	[EQX_DETAIL_SPINBUTTON_DOWN] = "spinbutton_down",
+	[EQX_DETAIL_SPINBUTTON_UP] = "spinbutton_up",
+	[EQX_DETAIL_STEPPER] = "stepper",
+	[EQX_DETAIL_TAB] = "tab",
+	[EQX_DETAIL_TEXT] = "text",
+	[EQX_DETAIL_TOOLBAR] = "toolbar",
+	[EQX_DETAIL_TOOLTIP] = "tooltip",
+	[EQX_DETAIL_TROUGH] = "trough",
+	[EQX_DETAIL_VIEWPORT] = "viewport",
+	[EQX_DETAIL_VSCALE] = "vscale",
+	[EQX_DETAIL_VSCROLLBAR] = "vscrollbar",
+	[EQX_DETAIL_CELL_EVEN] = "cell_even",
+	[EQX_DETAIL_CELL_ODD] = "cell_odd",
+	[EQX_DETAIL_TREEVIEW] = "treeview",
+};
+
+static const gchar *entry_names[EQX_ENTRY_LAST] = {
+	"box", "shadow", "flat_box", "box_gap", "shadow_gap", "extension",
+	"handle", "slider", "option", "check", "arrow", "focus", "layout",
+	"tab", "hline", "vline", "resize_grip"
+};
+
+static guint8 detail_slots[DETAIL_SLOTS];
+static gboolean detail_slots_built = FALSE;
+
+static guint detail_counters[EQX_ENTRY_LAST][EQX_DETAIL_LAST];
+static EquinoxDrawEntry current_entry = EQX_ENTRY_BOX;
+
+static inline guint
+detail_hash (const gchar *detail, gsize len)
+{
+	return ((guchar) detail[0] + (guchar) detail[len - 1] * 6 + (guchar) detail[1] * 8 + len * 11) & (DETAIL_SLOTS - 1);
+}
+
+static void
+detail_build_slots (void)
+{
+	guint id, slot;
+
+	for (id = EQX_DETAIL_UNKNOWN + 1; id < EQX_DETAIL_CELL_EVEN; id++) {
+		slot = detail_hash (detail_names[id], strlen (detail_names[id]));
+		if (detail_slots[slot])
+			g_warning ("equinox: details \"%s\" and \"%s\" share a hash slot",
+			           detail_names[id], detail_names[detail_slots[slot]]);
+		else
+			detail_slots[slot] = id;
+	}
+
+	detail_slots_built = TRUE;
+}
+
+EquinoxDetail
+equinox_detail_lookup (const gchar *detail)
+{
+	EquinoxDetail id;
+	gsize len;
+
+	if (detail == NULL)
+		return EQX_DETAIL_NONE;
+
+	if (G_UNLIKELY (!detail_slots_built))
+		detail_build_slots ();
+
+	len = strlen (detail);
+	if (len < 2)
+		return EQX_DETAIL_UNKNOWN;
+
+	id = detail_slots[detail_hash (detail, len)];
+	if (id && strcmp (detail_names[id], detail) == 0)
+		return id;
+
+	/* tree views append row/column flags to these */
+	if (detail[0] == 'c' && strncmp ("cell_even", detail, 9) == 0)
+		return EQX_DETAIL_CELL_EVEN;
+	if (detail[0] == 'c' && strncmp ("cell_odd", detail, 8) == 0)
+		return EQX_DETAIL_CELL_ODD;
+	if (detail[0] == 't' && strncmp ("treeview", detail, 8) == 0)
+		return EQX_DETAIL_TREEVIEW;
+
+	return EQX_DETAIL_UNKNOWN;
+}
+
+/* Like equinox_detail_lookup, counting the call for the given entry point */
+EquinoxDetail
+equinox_detail_resolve (const gchar *detail, EquinoxDrawEntry entry)
+{
+	EquinoxDetail id = equinox_detail_lookup (detail);
+
+	detail_counters[entry][id]++;
+	current_entry = entry;
+
+	return id;
+}
+
+/* The entry point that resolved a detail last, i.e. the one drawing now */
+EquinoxDrawEntry
+equinox_detail_current_entry (void)
+{
+	return current_entry;
+}
+
+const gchar *
+equinox_detail_entry_name (EquinoxDrawEntry entry)
+{
+	return entry_names[entry];
+}
+
+guint
+equinox_detail_get_count (EquinoxDrawEntry entry, EquinoxDetail id)
+{
+	return detail_counters[entry][id];
+}
+
+void
+equinox_detail_print_stats (void)
+{
+	guint entry, id;
+
+	for (entry = 0; entry < EQX_ENTRY_LAST; entry++) {
+		for (id = 0; id < EQX_DETAIL_LAST; id++) {
+			if (detail_counters[entry][id] == 0)
+				continue;
+
+			g_printerr ("equinox: draw_%s %s: %u\n", entry_names[entry],
+			            id == EQX_DETAIL_NONE ? "(none)" : id == EQX_DETAIL_UNKNOWN ? "(other)" : detail_names[id],
+			            detail_counters[entry][id]);
+		}
+	}
+}
@@ -0,0 +1,104 @@
+/* Equinox Engine
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef EQUINOX_DETAIL_H
+#define EQUINOX_DETAIL_H
+
+#include <glib.h>
+
+/* The detail strings the style functions know about.  Anything else
+ * resolves to EQX_DETAIL_UNKNOWN. */
+typedef enum {
+	EQX_DETAIL_NONE,
+	EQX_DETAIL_UNKNOWN,
+	EQX_DETAIL_ACCELLABEL,
+	EQX_DETAIL_ARROW,
+	EQX_DETAIL_BAR,
+	EQX_DETAIL_BUTTON,
+	EQX_DETAIL_BUTTONDEFAULT,
+	EQX_DETAIL_CELLCHECK,
+	EQX_DETAIL_CELLRADIO,
+	EQX_DETAIL_CELLRENDERERTEXT,
+	EQX_DETAIL_CHECKBUTTON,
+	EQX_DETAIL_DOCKITEM_BIN,
+	EQX_DETAIL_ENTRY,
+	EQX_DETAIL_EXPANDER,
+	EQX_DETAIL_FRAME,
+	EQX_DETAIL_HANDLEBOX,
+	EQX_DETAIL_HANDLEBOX_BIN,
+	EQX_DETAIL_HSCALE,
+	EQX_DETAIL_HSCROLLBAR,
+	EQX_DETAIL_MENU,
+	EQX_DETAIL_MENUBAR,
+	EQX_DETAIL_MENUITEM,
+	EQX_DETAIL_NOTEBOOK,
+	EQX_DETAIL_OPTIONMENU,
+	EQX_DETAIL_PAGER,
+	EQX_DETAIL_PAGER_FRAME,
+	EQX_DETAIL_PANED,
+	EQX_DETAIL_SCROLLED_WINDOW,
+	EQX_DETAIL_SLIDER,
+	EQX_DETAIL_SPINBUTTON,
+	EQX_DETAIL_SPINBUTTON_DOWN,
+	EQX_DETAIL_SPINBUTTON_UP,
+	EQX_DETAIL_STEPPER,
+	EQX_DETAIL_TAB,
+	EQX_DETAIL_TEXT,
+	EQX_DETAIL_TOOLBAR,
+	EQX_DETAIL_TOOLTIP,
+	EQX_DETAIL_TROUGH,
+	EQX_DETAIL_VIEWPORT,
+	EQX_DETAIL_VSCALE,
+	EQX_DETAIL_VSCROLLBAR,
+	/* prefix families */
+	EQX_DETAIL_CELL_EVEN,
+	EQX_DETAIL_CELL_ODD,
+	EQX_DETAIL_TREEVIEW,
+	EQX_DETAIL_LAST
+} EquinoxDetail;
+
+/* Style entry points, used to split the per-detail counters */
+typedef enum {
+	EQX_ENTRY_BOX,
+	EQX_ENTRY_SHADOW,
+	EQX_ENTRY_FLAT_BOX,
+	EQX_ENTRY_BOX_GAP,
+	EQX_ENTRY_SHADOW_GAP,
+	EQX_ENTRY_EXTENSION,
+	EQX_ENTRY_HANDLE,
+	EQX_ENTRY_SLIDER,
+	EQX_ENTRY_OPTION,
+	EQX_ENTRY_CHECK,
+	EQX_ENTRY_ARROW,
+	EQX_ENTRY_FOCUS,
+	EQX_ENTRY_LAYOUT,
+	EQX_ENTRY_TAB,
+	EQX_ENTRY_HLINE,
+	EQX_ENTRY_VLINE,
+	EQX_ENTRY_RESIZE_GRIP,
+	EQX_ENTRY_LAST
+} EquinoxDrawEntry;
+
+G_GNUC_INTERNAL EquinoxDetail equinox_detail_lookup (const gchar *detail);
+G_GNUC_INTERNAL EquinoxDetail equinox_detail_resolve (const gchar *detail, EquinoxDrawEntry entry);
+G_GNUC_INTERNAL EquinoxDrawEntry equinox_detail_current_entry (void);
+G_GNUC_INTERNAL const gchar  *equinox_detail_entry_name (EquinoxDrawEntry entry);
+G_GNUC_INTERNAL guint         equinox_detail_get_count (EquinoxDrawEntry entry, EquinoxDetail id);
+G_GNUC_INTERNAL void          equinox_detail_print_stats (void);
+
+#endif /* EQUINOX_DETAIL_H */
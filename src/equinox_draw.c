@@ -3,6 +3,7 @@
 #include "equinox_types.h"
 
 #include "support.h"
+#include "equinox_cache.h"
 
 #include <cairo.h>
 #include <math.h>
@@ -117,6 +118,9 @@ rotate_mirror_translate (cairo_t * cr, double radius, double x, double y,
 static void  equinox_rectangle (cairo_t *cr, EquinoxCairoOps ops,
 				double x, double y, double w, double h,
 				const EquinoxRGB *color, double alpha) {
+	if (ops == EQX_CAIRO_STROKE ? equinox_cull_outline (cr, x, y, w, h, 0) : equinox_cull_box (cr, x, y, w, h))
+		return;
+
 	cairo_rectangle (cr, x, y, w, h);
 	equinox_set_source_rgba (cr, color, alpha);
 	if (ops == EQX_CAIRO_STROKE)
@@ -129,6 +133,9 @@ static void  equinox_rounded_rectangle (cairo_t *cr, EquinoxCairoOps ops,
 				double x, double y, double w, double h,
 				double radius, uint8 corners,
 				const EquinoxRGB *color, double alpha) {
+	if (ops == EQX_CAIRO_STROKE ? equinox_cull_outline (cr, x, y, w, h, radius) : equinox_cull_box (cr, x, y, w, h))
+		return;
+
 	clearlooks_rounded_rectangle (cr, x, y, w, h, radius, corners);
 	equinox_set_source_rgba (cr, color, alpha);
 	if (ops == EQX_CAIRO_STROKE)
@@ -141,6 +148,11 @@ static void  equinox_rounded_gradient (cairo_t *cr, EquinoxCairoOps ops,
 				double x, double y, double w, double h,
 				double radius, uint8 corners,
 				cairo_pattern_t *pattern) {
+	if (ops == EQX_CAIRO_STROKE ? equinox_cull_outline (cr, x, y, w, h, radius) : equinox_cull_box (cr, x, y, w, h)) {
+		cairo_pattern_destroy (pattern);
+		return;
+	}
+
 	cairo_set_source (cr, pattern);
 	clearlooks_rounded_rectangle (cr, x, y, w, h, radius, corners);
 	if (ops == EQX_CAIRO_STROKE)
@@ -153,6 +165,11 @@ static void  equinox_rounded_gradient (cairo_t *cr, EquinoxCairoOps ops,
 static void  equinox_rectangle_gradient (cairo_t *cr, EquinoxCairoOps ops,
 				double x, double y, double w, double h,
 				cairo_pattern_t *pattern) {
+	if (ops == EQX_CAIRO_STROKE ? equinox_cull_outline (cr, x, y, w, h, 0) : equinox_cull_box (cr, x, y, w, h)) {
+		cairo_pattern_destroy (pattern);
+		return;
+	}
+
 	cairo_set_source (cr, pattern);
 	cairo_rectangle (cr, x, y, w, h);
 	if (ops == EQX_CAIRO_STROKE)
@@ -165,6 +182,10 @@ static void  equinox_rectangle_gradient (cairo_t *cr, EquinoxCairoOps ops,
 static void  equinox_arc (cairo_t *cr, EquinoxCairoOps ops,
 				double xc, double yc, double radius, double angle1, double angle2,
 				const EquinoxRGB *color, double alpha) {
+	/* the whole circle; the outline test only culls outside it */
+	if (equinox_cull_outline (cr, xc - radius, yc - radius, 2 * radius, 2 * radius, radius))
+		return;
+
 	equinox_set_source_rgba (cr, color, alpha);
 	cairo_arc (cr, xc, yc, radius, angle1, angle2);
 	if (ops == EQX_CAIRO_STROKE)
@@ -176,6 +197,11 @@ static void  equinox_arc (cairo_t *cr, EquinoxCairoOps ops,
 static void  equinox_arc_gradient (cairo_t *cr, EquinoxCairoOps ops,
 				double xc, double yc, double radius, double angle1, double angle2,
 				cairo_pattern_t *pattern) {
+	if (equinox_cull_outline (cr, xc - radius, yc - radius, 2 * radius, 2 * radius, radius)) {
+		cairo_pattern_destroy (pattern);
+		return;
+	}
+
 	cairo_set_source (cr, pattern);
 	cairo_arc (cr, xc, yc, radius, angle1, angle2);
 	if (ops == EQX_CAIRO_STROKE)
@@ -185,9 +211,10 @@ static void  equinox_arc_gradient (cairo_t *cr, EquinoxCairoOps ops,
 	cairo_pattern_destroy (pattern);
 }
 
-static void equinox_draw_inset_circle (cairo_t * cr, double xc, double yc, double radius, const EquinoxRGB *color, int orientation) {
+static void equinox_draw_inset_circle_real (cairo_t * cr, double xc, double yc, double radius, const EquinoxRGB *color, int orientation) {
 	EquinoxRGB dark, middle, light;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	double lightness = equinox_get_lightness(color);
 
@@ -201,23 +228,50 @@ static void equinox_draw_inset_circle (cairo_t * cr, double xc, double yc, doubl
 
 
 	if (orientation == 0)
-		pattern = cairo_pattern_create_linear (0, yc - radius, 0, yc + radius);
+		equinox_gradient_init (&gradient, 0, yc - radius, 0, yc + radius);
 	else
-		pattern = cairo_pattern_create_linear (xc - radius, 0, xc + radius, 0);
-	equinox_pattern_add_color_rgba (pattern, 0.0, &dark, 0.85);
-	equinox_pattern_add_color_rgba (pattern, 0.6, &middle, 0.85);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &light, 0.85);
+		equinox_gradient_init (&gradient, xc - radius, 0, xc + radius, 0);
+	equinox_gradient_add_rgba (&gradient, 0.0, &dark, 0.85);
+	equinox_gradient_add_rgba (&gradient, 0.6, &middle, 0.85);
+	equinox_gradient_add_rgba (&gradient, 1.0, &light, 0.85);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_arc_gradient (cr, EQX_CAIRO_FILL, xc, yc, radius, 0, M_PI * 2, pattern);
 
 	if (orientation == 0)
-		pattern = cairo_pattern_create_linear (0, yc - radius, 0, yc + radius);
+		equinox_gradient_init (&gradient, 0, yc - radius, 0, yc + radius);
 	else
-		pattern = cairo_pattern_create_linear (xc - radius, 0, xc + radius, 0);
-	equinox_pattern_add_color_rgba (pattern, 0.5, &dark, 0.25);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &light, 0.25);
+		equinox_gradient_init (&gradient, xc - radius, 0, xc + radius, 0);
+	equinox_gradient_add_rgba (&gradient, 0.5, &dark, 0.25);
+	equinox_gradient_add_rgba (&gradient, 1.0, &light, 0.25);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_arc_gradient (cr, EQX_CAIRO_STROKE, xc, yc, radius - 0.5, 0, M_PI * 2, pattern);
 }
 
+/* Handle dots and grips go through the indicator atlas when they sit on the
+ * pixel grid and fit in a cell. */
+static void equinox_draw_inset_circle (cairo_t * cr, const EquinoxColors * colors, double xc, double yc, double radius, const EquinoxRGB *color, int orientation) {
+	EquinoxAtlasKey key;
+	EquinoxAtlasSprite sprite;
+	cairo_t *atlas_cr;
+
+	if (xc != floor (xc) || yc != floor (yc) || radius > EQX_ATLAS_PAD - 1 ||
+	    !equinox_atlas_key_init (&key, EQX_ATLAS_INSET_CIRCLE, colors, 0, orientation)) {
+		equinox_draw_inset_circle_real (cr, xc, yc, radius, color, orientation);
+		return;
+	}
+
+	key.size = radius * 2;
+	key.color = *color;
+
+	if (!equinox_atlas_lookup (&key, &sprite)) {
+		atlas_cr = equinox_atlas_begin_render (&key, &sprite);
+		equinox_draw_inset_circle_real (atlas_cr, sprite.x, sprite.y, radius, color, orientation);
+		cairo_destroy (atlas_cr);
+	}
+
+	equinox_atlas_blit (cr, &sprite, xc, yc);
+}
+
 static void equinox_draw_etched_shadow (cairo_t * cr, double x, double y, double width,
 			    double height, double radius, uint8 corners,
 			    const EquinoxRGB*  bg_color, double highlight_modifier) {
@@ -225,20 +279,23 @@ static void equinox_draw_etched_shadow (cairo_t * cr, double x, double y, double
 	EquinoxRGB shadow;
 	EquinoxRGB highlight;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	equinox_shade (bg_color, &shadow, 0.82);
 	equinox_shade (bg_color, &highlight, 1.25 * highlight_modifier);
 
 	// the highlight
-	pattern = cairo_pattern_create_linear (0, y, 0, y + height);
-	equinox_pattern_add_color_rgba (pattern, 0.75, bg_color, 0.0);
-	equinox_pattern_add_color_rgba (pattern, 0.95, &highlight, 0.64);
+	equinox_gradient_init (&gradient, 0, y, 0, y + height);
+	equinox_gradient_add_rgba (&gradient, 0.75, bg_color, 0.0);
+	equinox_gradient_add_rgba (&gradient, 0.95, &highlight, 0.64);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, x, y, width, height, radius, corners, pattern);
 
 	// the shadow
-	pattern = cairo_pattern_create_linear (0, y, 0, y + height);
-	equinox_pattern_add_color_rgba (pattern, 0.0, &shadow, 0.32);
-	equinox_pattern_add_color_rgba (pattern, 1.0, bg_color, 0.06);
+	equinox_gradient_init (&gradient, 0, y, 0, y + height);
+	equinox_gradient_add_rgba (&gradient, 0.0, &shadow, 0.32);
+	equinox_gradient_add_rgba (&gradient, 1.0, bg_color, 0.06);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, x + 0.5, y, width - 1, height, radius, corners, pattern);
 }
 
@@ -250,19 +307,21 @@ equinox_draw_shadow (cairo_t * cr, double x, double y, double width,
 
 	EquinoxRGB shadow;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	if (alpha < 1) {
 		equinox_shade (bg_color, &shadow, 0.885);
-		pattern = cairo_pattern_create_linear (0, y, 0, y + height + 1);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &shadow, 0.0);
-		equinox_pattern_add_color_rgba (pattern, 0.4, &shadow, 0.75 * alpha);
-		equinox_pattern_add_color_rgba (pattern, 1.0 , &shadow, alpha);
+		equinox_gradient_init (&gradient, 0, y, 0, y + height + 1);
+		equinox_gradient_add_rgba (&gradient, 0.0, &shadow, 0.0);
+		equinox_gradient_add_rgba (&gradient, 0.4, &shadow, 0.75 * alpha);
+		equinox_gradient_add_rgba (&gradient, 1.0 , &shadow, alpha);
 	} else {
 		equinox_shade (bg_color, &shadow, 0.90);
-		pattern = cairo_pattern_create_linear (0, y, 0, y + height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, bg_color);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &shadow);
+		equinox_gradient_init (&gradient, 0, y, 0, y + height);
+		equinox_gradient_add_rgb (&gradient, 0.0, bg_color);
+		equinox_gradient_add_rgb (&gradient, 1.0, &shadow);
 	}
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, x + 0.5, y + 1, width - 1, height - 1, radius, corners, pattern);
 }
 
@@ -272,14 +331,16 @@ static void equinox_draw_border (cairo_t * cr, double x, double y, double width,
 		    double height, double radius, uint8 corners,
 		    const EquinoxRGB*  border, double lighter, double darker) {
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 	EquinoxRGB border_darker, border_lighter;
 	equinox_shade_shift (border, &border_darker, darker);
 	equinox_shade_shift (border, &border_lighter, lighter);
 
-	pattern = cairo_pattern_create_linear (0, y, 0, y + height);
-	equinox_pattern_add_color_rgb (pattern, 0.0, &border_lighter);
-	equinox_pattern_add_color_rgb (pattern, 0.5, border);
-	equinox_pattern_add_color_rgb (pattern, 1.0, &border_darker);
+	equinox_gradient_init (&gradient, 0, y, 0, y + height);
+	equinox_gradient_add_rgb (&gradient, 0.0, &border_lighter);
+	equinox_gradient_add_rgb (&gradient, 0.5, border);
+	equinox_gradient_add_rgb (&gradient, 1.0, &border_darker);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, x, y, width, height, radius, corners, pattern);
 }
 
@@ -287,15 +348,17 @@ static void equinox_draw_etched_border (cairo_t * cr, double x, double y, double
 		    double height, double radius, uint8 corners,
 		    const EquinoxRGB*  border, double lighter, double darker) {
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 	EquinoxRGB border_darker, border_lighter;
 	equinox_shade_shift (border, &border_darker, darker);
 	equinox_shade_shift (border, &border_lighter, lighter);
 
-	pattern = cairo_pattern_create_linear (0, y, 0, y + height);
-	equinox_pattern_add_color_rgb (pattern, (radius/2+1)/height, &border_darker);
-	equinox_pattern_add_color_rgb (pattern, (radius/2+1)/height, border);
-	equinox_pattern_add_color_rgba (pattern, (height-radius/2-1)/height, border, 0.90);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &border_lighter, 0.65);
+	equinox_gradient_init (&gradient, 0, y, 0, y + height);
+	equinox_gradient_add_rgb (&gradient, (radius/2+1)/height, &border_darker);
+	equinox_gradient_add_rgb (&gradient, (radius/2+1)/height, border);
+	equinox_gradient_add_rgba (&gradient, (height-radius/2-1)/height, border, 0.90);
+	equinox_gradient_add_rgba (&gradient, 1.0, &border_lighter, 0.65);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, x, y, width, height, radius, corners, pattern);
 }
 
@@ -332,12 +395,175 @@ static void equinox_draw_inner_glow (cairo_t * cr, double x, double y, double wi
 // Widget Functions
 
 
+/*
+  Computes the button colours from the (possibly animated) fill colour.
+  Used to build the derived palette and for buttons in mid transition.
+*/
+static void
+equinox_button_colors (const EquinoxColors * colors, const EquinoxRGB * fill,
+		      boolean active, boolean prelight, boolean disabled,
+		      int buttonstyle, EquinoxButtonColors * button)
+{
+	double lightness = colors->derived.bg_lightness;
+	double highlight_scale = lightness < 0.6 ? 0.19*(0.6-lightness):0;//0.15*(0.902-lightness);
+
+	button->fill = *fill;
+
+	//Highlight
+	if (disabled)
+		equinox_shade_shift (fill, &button->highlight, 1.05 + 0.25*highlight_scale);
+	else if (active && !prelight)
+		equinox_shade_shift (fill, &button->highlight, 1.05 + 0.5*highlight_scale);
+	else
+		equinox_shade_shift (fill, &button->highlight, 1.06 + highlight_scale); // 1.10
+
+	//border color a blend of bg color and button color
+	equinox_mix_color (&colors->shade[disabled?4:8], fill, 0.30, &button->border);
+	equinox_tweak_saturation (fill, &button->border);
+	equinox_shade (&button->border, &button->shadow, 0.75);
+
+	if (buttonstyle == 1) {
+		equinox_shade (fill, &button->fill_darker, 0.88); // 0.82
+		equinox_shade (fill, &button->highlight, lightness < 0.5 ? 1.5 : 1.225); // 1.175
+
+		equinox_mix_color (&button->fill_darker, &button->highlight, 0.85, &button->highlight); // 0.65
+		equinox_mix_color (&button->fill_darker, &button->highlight, 0.4, &button->mid_highlight); // 0.45
+	} else if (active) {
+		equinox_shade_shift (fill, &button->fill_darker, disabled? 0.96 : 0.93); // 0.95 : 0.91
+		equinox_mix_color (fill, &button->highlight, 0.10 + 0.10*highlight_scale, &button->mid_highlight);
+	} else {
+		equinox_shade_shift (fill, &button->fill_darker, disabled? 0.96 : 0.91); // 0.95 : 0.88
+		equinox_mix_color (fill, &button->highlight, 0.10 + 0.65*highlight_scale, &button->mid_highlight);
+	}
+
+	equinox_shade_shift (&button->highlight, &button->edge_highlight, disabled? 1.05 : 1.1);
+}
+
+/*
+  Fills colors->derived from the base palette.  Called from
+  equinox_style_realize once the palette is complete.
+*/
+void
+equinox_derive_colors (EquinoxColors * colors, int buttonstyle)
+{
+	EquinoxDerivedColors *derived = &colors->derived;
+	EquinoxRGB fill;
+	int state, variant;
+
+	derived->bg_lightness = equinox_get_lightness (&colors->bg[GTK_STATE_NORMAL]);
+	derived->prelight_lightness = equinox_get_lightness (&colors->bg[GTK_STATE_PRELIGHT]);
+	derived->spot_lightness = equinox_get_lightness (&colors->spot[1]);
+
+	derived->buttonstyle = buttonstyle;
+	for (state = 0; state < 5; state++) {
+		for (variant = 0; variant < EQX_BUTTON_VARIANTS; variant++) {
+			boolean active = (variant % 3) != 0;
+			boolean prelight = (variant % 3) == 2;
+			boolean disabled = variant >= 3;
+
+			fill = colors->bg[state];
+			if (active && prelight)
+				equinox_shade (&fill, &fill, 0.78);
+			equinox_button_colors (colors, &fill, active, prelight, disabled, buttonstyle, &derived->button[state][variant]);
+		}
+	}
+
+	//Sorted list header in prelight: active colour raised by the prelight/normal difference
+	derived->header_sorted_prelight = colors->bg[GTK_STATE_ACTIVE];
+	equinox_set_lightness (&derived->header_sorted_prelight,
+	                       equinox_get_lightness (&derived->header_sorted_prelight) + derived->prelight_lightness - derived->bg_lightness);
+
+	//Progress bar fill
+	equinox_shade_shift (&colors->spot[1], &derived->spot_darker, 0.75);
+	equinox_shade_shift (&colors->spot[1], &derived->spot_lighter, 1.08);
+	equinox_shade_shift (&derived->spot_darker, &derived->spot_stripe, 0.95);
+	equinox_shade_shift (&colors->spot[1], &derived->spot_highlight, 1.25 + (1.0 - derived->spot_lightness) * 0.25);
+	equinox_shade_shift (&colors->spot[2], &derived->spot_border_darker, 1.1);
+	equinox_shade_shift (&colors->spot[1], &derived->spot_border_lighter[0], 1.4);
+	equinox_shade_shift (&colors->spot[2], &derived->spot_border_lighter[1], 1.25);
+}
+
 /*
   Draws the buttons, toolbar buttons and toggle buttons
   Varries based on disabled, active, prelight and focus states
 */
-void
-equinox_draw_button (cairo_t * cr,
+/* A state transition is drawn as a cross-fade: the widget settled in the
+ * state it comes from, faded out, plus the widget settled in its new state,
+ * faded in.  Both ends are regular draws, so for the cached elements they
+ * are blits of surfaces rendered once, and a frame of the transition costs
+ * two blits and a composite instead of all the paths and gradients.
+ *
+ *   if (equinox_transition_begin (cr, widget, &from, &to, x, y, width, height)) {
+ *       draw with from
+ *       equinox_transition_next (cr, widget);
+ *       draw with to
+ *       equinox_transition_end (cr, widget);
+ *   }
+ *
+ * from and to have trans at 1.0, so drawing with them does not recurse. */
+#define EQX_STATE_CHANGING(widget) ((widget)->prev_state_type != (widget)->state_type)
+
+static gboolean
+equinox_transition_begin (cairo_t * cr, const WidgetParameters * widget,
+                          WidgetParameters * from, WidgetParameters * to,
+                          double x, double y, double width, double height)
+{
+	EquinoxStateType prev_state_type = widget->prev_state_type;
+
+	if (widget->trans >= 1.0)
+		return FALSE;
+
+	*to = *widget;
+	to->trans = 1.0;
+	to->prev_state_type = to->state_type;
+
+	*from = *to;
+	from->state_type = prev_state_type;
+	from->prev_state_type = prev_state_type;
+	from->prelight = (prev_state_type == GTK_STATE_PRELIGHT);
+	from->disabled = (prev_state_type == GTK_STATE_INSENSITIVE);
+	/* Pressed only if it was: a toggle button being switched on fades in
+	 * its pressed look, one being released comes from the active state.
+	 * widget->active is the new look and only goes to the "to" side. */
+	from->active = (prev_state_type == GTK_STATE_ACTIVE);
+
+	/* keeps the groups no larger than the element */
+	cairo_save (cr);
+	cairo_rectangle (cr, x, y, width, height);
+	cairo_clip (cr);
+
+	cairo_push_group (cr);
+	cairo_push_group (cr);
+
+	return TRUE;
+}
+
+static void
+equinox_transition_next (cairo_t * cr, const WidgetParameters * widget)
+{
+	cairo_pop_group_to_source (cr);
+	cairo_paint_with_alpha (cr, 1.0 - widget->trans);
+
+	cairo_push_group (cr);
+}
+
+static void
+equinox_transition_end (cairo_t * cr, const WidgetParameters * widget)
+{
+	/* adding the two weighted ends keeps what both have in common, like
+	 * translucent shadows, from getting darker halfway */
+	cairo_pop_group_to_source (cr);
+	cairo_set_operator (cr, CAIRO_OPERATOR_ADD);
+	cairo_paint_with_alpha (cr, widget->trans);
+
+	cairo_pop_group_to_source (cr);
+	cairo_paint (cr);
+
+	cairo_restore (cr);
+}
+
+static void
+equinox_draw_button_real (cairo_t * cr,
 		    const EquinoxColors * colors,
 		    const WidgetParameters * widget,
 		    int x, int y, int width, int height, int buttonstyle)
@@ -345,82 +571,64 @@ equinox_draw_button (cairo_t * cr,
 
 
 	//Fill color, highlight color and border color
+	const EquinoxButtonColors *derived;
+	EquinoxButtonColors button;
 	EquinoxRGB fill;
 	EquinoxRGB fill_darker, mid_highlight;
 	EquinoxRGB highlight;
 	EquinoxRGB border;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 	cairo_translate (cr, x, y);
 
-	fill = colors->bg[widget->state_type];
-#ifdef HAVE_ANIMATION
-	EquinoxRGB fill_old;
-	fill_old = colors->bg[widget->prev_state_type];
-#endif
+	/* nothing of the button is exposed */
+	if (equinox_cull_box (cr, 0, 0, width, height))
+		return;
 
-	double lightness = equinox_get_lightness(&colors->bg[GTK_STATE_NORMAL]);
-	double highlight_scale = lightness < 0.6 ? 0.19*(0.6-lightness):0;//0.15*(0.902-lightness);
+	double lightness = colors->derived.bg_lightness;
 	boolean focus_border = lightness > 0.6;
 
-	if (widget->active && widget->prelight)
-		equinox_shade (&fill, &fill, 0.78);
-
-#ifdef HAVE_ANIMATION
-	if (widget->active && widget->prev_state_type == GTK_STATE_PRELIGHT)
-		equinox_shade (&fill_old, &fill_old, 0.78);
-	equinox_mix_color (&fill_old, &fill, widget->trans, &fill);
-#endif
+	if (colors->derived.buttonstyle == buttonstyle) {
+		derived = &colors->derived.button[widget->state_type][EQX_BUTTON_VARIANT (widget->active, widget->prelight, widget->disabled)];
+	} else {
+		fill = colors->bg[widget->state_type];
+		if (widget->active && widget->prelight)
+			equinox_shade (&fill, &fill, 0.78);
 
-	//Highlight
-	if (widget->disabled)
-		equinox_shade_shift (&fill, &highlight, 1.05 + 0.25*highlight_scale);
-	else if (widget->active && !widget->prelight)
-		equinox_shade_shift (&fill, &highlight, 1.05 + 0.5*highlight_scale);
-	else
-		equinox_shade_shift (&fill, &highlight, 1.06 + highlight_scale); // 1.10
+		equinox_button_colors (colors, &fill, widget->active, widget->prelight, widget->disabled, buttonstyle, &button);
+		derived = &button;
+	}
 
-	//border color a blend of bg color and button color
-	equinox_mix_color (&colors->shade[widget->disabled?4:8], &fill, 0.30, &border);
-	equinox_tweak_saturation (&fill,&border);
+	fill = derived->fill;
+	fill_darker = derived->fill_darker;
+	mid_highlight = derived->mid_highlight;
+	highlight = derived->highlight;
+	border = derived->border;
 
 	int roundness = MIN (widget->curvature, (height - 4) / 2.0);
 
 	//Draw the fill
 	if (buttonstyle == 1) {
-		equinox_shade (&fill, &fill_darker, 0.88); // 0.82
-		equinox_shade (&fill, &highlight, lightness < 0.5 ? 1.5 : 1.225); // 1.175
-
-		equinox_mix_color (&fill_darker, &highlight, 0.85, &highlight); // 0.65
-		equinox_mix_color (&fill_darker, &highlight, 0.4, &mid_highlight); // 0.45
-
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &mid_highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &fill_darker);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &fill);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgb (&gradient, 0.5, &mid_highlight);
+		equinox_gradient_add_rgb (&gradient, 0.5, &fill_darker);
+		equinox_gradient_add_rgb (&gradient, 1.0, &fill);
   	} else {
-		if (widget->active) {
-			equinox_shade_shift (&fill, &fill_darker, widget->disabled? 0.96 : 0.93); // 0.95 : 0.91
-			equinox_mix_color (&fill, &highlight, 0.10 + 0.10*highlight_scale, &mid_highlight);
-		} else {
-			equinox_shade_shift (&fill, &fill_darker, widget->disabled? 0.96 : 0.91); // 0.95 : 0.88
-			equinox_mix_color (&fill, &highlight, 0.10 + 0.65*highlight_scale, &mid_highlight);
-		}
-
-		pattern = cairo_pattern_create_linear (2, 2, 2, height-4);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &mid_highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &fill);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &fill_darker);
+		equinox_gradient_init (&gradient, 2, 2, 2, height-4);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgb (&gradient, 0.5, &mid_highlight);
+		equinox_gradient_add_rgb (&gradient, 0.5, &fill);
+		equinox_gradient_add_rgb (&gradient, 1.0, &fill_darker);
 	}
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 2, 2, width-4, height-4, roundness - 1, widget->corners, pattern);
 
 	//Check if pressed...
 	if (widget->active) {
 		//"pressed" add an inner shadow
-		EquinoxRGB shadow;
+		EquinoxRGB shadow = derived->shadow;
 
-		equinox_shade (&border, &shadow, 0.75);
 		if (widget->focus && focus_border) {
 			equinox_mix_color (&shadow, &colors->spot[2], 0.85, &shadow);
 			equinox_shade_shift (&shadow, &shadow, lightness < 0.5 ? 1.5 : 1.2);
@@ -438,18 +646,19 @@ equinox_draw_button (cairo_t * cr,
 	}
 	else {
 		//If not pressed add a 1px highlight along the left and top
-		equinox_shade_shift (&highlight, &highlight, widget->disabled? 1.05 : 1.1);
+		highlight = derived->edge_highlight;
 
-		pattern = cairo_pattern_create_linear (2, 2, 2, height-4);
-		equinox_pattern_add_color_rgb  (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.12);
+		equinox_gradient_init (&gradient, 2, 2, 2, height-4);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.12);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 2.5, 2.5, width - 5, height - 5, roundness - 1, widget->corners, pattern);
 		cairo_stroke (cr);
 	}
 
 	//the etching/shadow and border
 	if (widget->active) {
-		equinox_draw_etched_shadow (cr, 0.5, 0.5, width - 1, height - 1.5, roundness + 1, widget->corners, &widget->parentbg, 1.0);
+		equinox_draw_etched_shadow (cr, 0.5, 0.5, width - 1, height - 1.5, roundness + 1, widget->corners, equinox_params_parentbg (widget), 1.0);
 		if (widget->focus && focus_border) {
 			equinox_mix_color (&border, &colors->spot[1], 0.85, &border);
 			equinox_shade_shift (&border, &border, 0.85);
@@ -499,7 +708,42 @@ equinox_draw_button (cairo_t * cr,
 }
 
 void
-equinox_draw_entry (cairo_t * cr,
+equinox_draw_button (cairo_t * cr,
+		    const EquinoxColors * colors,
+		    const WidgetParameters * widget,
+		    int x, int y, int width, int height, int buttonstyle)
+{
+	WidgetParameters from, to;
+	EquinoxCacheKey key;
+	cairo_surface_t *surface;
+	cairo_t *cache_cr;
+
+	if (EQX_STATE_CHANGING (widget) && equinox_transition_begin (cr, widget, &from, &to, x, y, width, height)) {
+		equinox_draw_button (cr, colors, &from, x, y, width, height, buttonstyle);
+		equinox_transition_next (cr, widget);
+		equinox_draw_button (cr, colors, &to, x, y, width, height, buttonstyle);
+		equinox_transition_end (cr, widget);
+		return;
+	}
+
+	if (!equinox_cache_key_init (&key, EQX_CACHE_BUTTON, colors, widget, width, height, buttonstyle, 0, widget->active)) {
+		equinox_draw_button_real (cr, colors, widget, x, y, width, height, buttonstyle);
+		return;
+	}
+
+	surface = equinox_cache_lookup (&key);
+	if (surface == NULL) {
+		cache_cr = equinox_cache_begin_render (&key, &surface);
+		equinox_draw_button_real (cache_cr, colors, widget, 0, 0, 2 * key.edge + 1, height, buttonstyle);
+		cairo_destroy (cache_cr);
+		equinox_cache_insert (&key, surface);
+	}
+
+	equinox_cache_blit (cr, surface, key.edge, x, y, width, height);
+}
+
+static void
+equinox_draw_entry_real (cairo_t * cr,
 		   const EquinoxColors * colors,
 		   const WidgetParameters * widget,
 		   const EntryParameters * entry,
@@ -508,8 +752,9 @@ equinox_draw_entry (cairo_t * cr,
 
 	EquinoxRGB fill;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 	EquinoxRGB color1, color2, parentbg1, parentbg2;
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 	boolean focus_border = (lightness > 0.6);
 
 	int roundness = MIN (widget->curvature, (height - 4) / 2.0);
@@ -517,35 +762,37 @@ equinox_draw_entry (cairo_t * cr,
 	// Fill the background (shouldn't have to)
 	if (entry->isToolbarItem && !entry->isComboButton) {
 		if (toolbarstyle==0 || toolbarstyle==2) {
-			equinox_set_source_rgb (cr, &widget->parentbg);
-			cairo_rectangle (cr, 0, 0, width, height);
+			equinox_set_source_rgb (cr, equinox_params_parentbg (widget));
+			cairo_rectangle (cr, x, y, width, height);
 			cairo_fill (cr);
-			parentbg1 = widget->parentbg;
-			parentbg2 = widget->parentbg;
+			parentbg1 = (*equinox_params_parentbg (widget));
+			parentbg2 = (*equinox_params_parentbg (widget));
 		} else {
-			equinox_shade (&widget->parentbg, &parentbg1, 0.92);
-			equinox_shade (&widget->parentbg, &parentbg2, 0.84);
-			pattern = cairo_pattern_create_linear (0, 0, 0, height);
-			equinox_pattern_add_color_rgb (pattern, 0.0, &parentbg1);
-			equinox_pattern_add_color_rgb (pattern, 1.0, &parentbg2);
-			equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
+			equinox_shade (equinox_params_parentbg (widget), &parentbg1, 0.92);
+			equinox_shade (equinox_params_parentbg (widget), &parentbg2, 0.84);
+			equinox_gradient_init (&gradient, 0, y, 0, y + height);
+			equinox_gradient_add_rgb (&gradient, 0.0, &parentbg1);
+			equinox_gradient_add_rgb (&gradient, 1.0, &parentbg2);
+			pattern = equinox_gradient_get_pattern (&gradient);
+			equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, x, y, width, height, pattern);
 		}
 	} else {
-		equinox_set_source_rgb (cr, &widget->parentbg);
-		cairo_rectangle (cr, 0, 0, width, height);
+		equinox_set_source_rgb (cr, equinox_params_parentbg (widget));
+		cairo_rectangle (cr, x, y, width, height);
 		cairo_fill (cr);
-		parentbg1 = widget->parentbg;
-		parentbg2 = widget->parentbg;
+		parentbg1 = (*equinox_params_parentbg (widget));
+		parentbg2 = (*equinox_params_parentbg (widget));
 	}
 
   cairo_translate (cr, x + 0.5, y + 0.5);
 	equinox_rounded_rectangle (cr, EQX_CAIRO_FILL, 0.5, 0.5, width - 2, height - 2, roundness - 0.5, widget->corners, &colors->base[widget->state_type], 1.0);
 
 	//highlight
-	equinox_shade (&parentbg2, &color2, equinox_get_lightness(&colors->bg[GTK_STATE_NORMAL]) > 0.6 ? 1.08 : 1.2);
-	pattern = cairo_pattern_create_linear (0, 0, 0, height);
-	equinox_pattern_add_color_rgba (pattern, 0.0, &color2, 0.0);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &color2, 0.8);
+	equinox_shade (&parentbg2, &color2, colors->derived.bg_lightness > 0.6 ? 1.08 : 1.2);
+	equinox_gradient_init (&gradient, 0, 0, 0, height);
+	equinox_gradient_add_rgba (&gradient, 0.0, &color2, 0.0);
+	equinox_gradient_add_rgba (&gradient, 1.0, &color2, 0.8);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 0, 1, width - 1, height - 2, roundness + 1, widget->corners, pattern);
 
 	//inner shadow
@@ -554,12 +801,13 @@ equinox_draw_entry (cairo_t * cr,
 	if (widget->focus && focus_border) {
 		equinox_mix_color (&colors->base[widget->state_type], &colors->spot[1], 0.15, &color1);
 	} else {
-		equinox_mix_color (&colors->base[widget->state_type], &widget->parentbg, 0.35, &color1);
+		equinox_mix_color (&colors->base[widget->state_type], equinox_params_parentbg (widget), 0.35, &color1);
 	}
 	equinox_shade (&color1, &color1, (widget->disabled ? 0.92 : 0.78) - 0.01 * 1 / lightness);
-	pattern = cairo_pattern_create_linear (0, 2, 0, height - 4);
-	equinox_pattern_add_color_rgba (pattern, 0.0, &color1, 0.64);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &color1, 0.32);
+	equinox_gradient_init (&gradient, 0, 2, 0, height - 4);
+	equinox_gradient_add_rgba (&gradient, 0.0, &color1, 0.64);
+	equinox_gradient_add_rgba (&gradient, 1.0, &color1, 0.32);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 1 + x_offset, 2, width - 3 + width_offset, height - 5, roundness - 1, widget->corners, pattern);
 	equinox_rounded_rectangle (cr, EQX_CAIRO_STROKE, 2 + (2*x_offset), 3, width - 5 + (2*width_offset), height - 7, roundness - 2, widget->corners, &color1, 0.12);
 
@@ -571,9 +819,10 @@ equinox_draw_entry (cairo_t * cr,
 		equinox_shade (&parentbg1, &color1, (widget->disabled ? 0.75 : 0.56) - 0.03 * 1 / lightness);
 		equinox_shade (&parentbg2, &color2, (widget->disabled ? 0.92 : 0.88) - 0.03 * 1 / lightness);
 	}
-	pattern = cairo_pattern_create_linear (0, 0, 0, height);
-	equinox_pattern_add_color_rgb (pattern, 0.0, &color1);
-	equinox_pattern_add_color_rgb (pattern, 1.0, &color2);
+	equinox_gradient_init (&gradient, 0, 0, 0, height);
+	equinox_gradient_add_rgb (&gradient, 0.0, &color1);
+	equinox_gradient_add_rgb (&gradient, 1.0, &color2);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 0, 1, width - 1, height - 3, roundness, widget->corners, pattern);
 
 	//Focus line
@@ -615,6 +864,47 @@ equinox_draw_entry (cairo_t * cr,
 
 }
 
+void
+equinox_draw_entry (cairo_t * cr,
+		   const EquinoxColors * colors,
+		   const WidgetParameters * widget,
+		   const EntryParameters * entry,
+		   int x, int y, int width, int height, int toolbarstyle)
+{
+	WidgetParameters from, to;
+	EquinoxCacheKey key;
+	cairo_surface_t *surface;
+	cairo_t *cache_cr;
+	guint8 flags;
+
+	/* entries fade their focus ring in and out */
+	if (equinox_transition_begin (cr, widget, &from, &to, x, y, width, height)) {
+		from.focus = !to.focus;
+		equinox_draw_entry (cr, colors, &from, entry, x, y, width, height, toolbarstyle);
+		equinox_transition_next (cr, widget);
+		equinox_draw_entry (cr, colors, &to, entry, x, y, width, height, toolbarstyle);
+		equinox_transition_end (cr, widget);
+		return;
+	}
+
+	flags = entry->type | (entry->isComboButton ? 4 : 0) | (entry->isSpinButton ? 8 : 0) | (entry->isToolbarItem ? 16 : 0);
+
+	if (!equinox_cache_key_init (&key, EQX_CACHE_ENTRY, colors, widget, width, height, toolbarstyle, flags, TRUE)) {
+		equinox_draw_entry_real (cr, colors, widget, entry, x, y, width, height, toolbarstyle);
+		return;
+	}
+
+	surface = equinox_cache_lookup (&key);
+	if (surface == NULL) {
+		cache_cr = equinox_cache_begin_render (&key, &surface);
+		equinox_draw_entry_real (cache_cr, colors, widget, entry, 0, 0, 2 * key.edge + 1, height, toolbarstyle);
+		cairo_destroy (cache_cr);
+		equinox_cache_insert (&key, surface);
+	}
+
+	equinox_cache_blit (cr, surface, key.edge, x, y, width, height);
+}
+
 
 void
 equinox_draw_scale_trough (cairo_t * cr,
@@ -628,7 +918,7 @@ equinox_draw_scale_trough (cairo_t * cr,
 	int tx, ty, tw, th; // Coordinates and dimensions of trough
 	int fill_size = slider->fill_size;
 	const double ROUNDNESS = SCALE_TROUGH_SIZE / 2;
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 
 	if (slider->horizontal) {
 		tx = 1;
@@ -657,10 +947,11 @@ equinox_draw_scale_trough (cairo_t * cr,
 	cairo_translate (cr, x, y);
 	//equinox_rectangle (cr, EQX_CAIRO_STROKE, 0.5, 0.5, width-1, height-1, &colors->shade[5], 1.0);
 
-	EquinoxRGB fill = widget->parentbg;
+	EquinoxRGB fill = (*equinox_params_parentbg (widget));
 	EquinoxRGB lighter, darker, mid;
 	EquinoxRGB border;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	equinox_shade (&fill, &fill, 0.88 - 0.075 * 1 / lightness);
 	equinox_shade (&fill, &border, 0.35);
@@ -670,13 +961,14 @@ equinox_draw_scale_trough (cairo_t * cr,
 	equinox_shade (&fill, &mid, 0.95);
 
 	if (slider->horizontal)
-		pattern = cairo_pattern_create_linear (0, ty, 0, ty + th);
+		equinox_gradient_init (&gradient, 0, ty, 0, ty + th);
 	else
-		pattern = cairo_pattern_create_linear (tx, 0, tx + tw, 0);
-	equinox_pattern_add_color_rgb (pattern, 0.00, &border);
-	equinox_pattern_add_color_rgb (pattern, 0.08, &darker);
-	equinox_pattern_add_color_rgb (pattern, 0.80, &mid);
-	equinox_pattern_add_color_rgb (pattern, 1.00, &fill);
+		equinox_gradient_init (&gradient, tx, 0, tx + tw, 0);
+	equinox_gradient_add_rgb (&gradient, 0.00, &border);
+	equinox_gradient_add_rgb (&gradient, 0.08, &darker);
+	equinox_gradient_add_rgb (&gradient, 0.80, &mid);
+	equinox_gradient_add_rgb (&gradient, 1.00, &fill);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_FILL, tx, ty, tw, th, ROUNDNESS, EQX_CORNER_ALL, pattern);
 
 	if (fill_size > 0) {
@@ -687,11 +979,12 @@ equinox_draw_scale_trough (cairo_t * cr,
 		equinox_shade_shift (&border, &darker, 0.70);
 
 		if (slider->inverted)
-			pattern = cairo_pattern_create_linear (slider->horizontal ? fw : 0, slider->horizontal ? 0 : fh, 0, 0);
+			equinox_gradient_init (&gradient, slider->horizontal ? fw : 0, slider->horizontal ? 0 : fh, 0, 0);
 		else
-			pattern = cairo_pattern_create_linear (0, 0, slider->horizontal ? tw - 2 : 0, slider->horizontal ? 0 : th - 2);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &darker);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &lighter);
+			equinox_gradient_init (&gradient, 0, 0, slider->horizontal ? tw - 2 : 0, slider->horizontal ? 0 : th - 2);
+		equinox_gradient_add_rgb (&gradient, 0.0, &darker);
+		equinox_gradient_add_rgb (&gradient, 1.0, &lighter);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, fx, fy, fw, fh, ROUNDNESS, EQX_CORNER_ALL, pattern);
 
 		// Shading
@@ -699,15 +992,16 @@ equinox_draw_scale_trough (cairo_t * cr,
 		equinox_shade_shift (&colors->base[GTK_STATE_SELECTED], &darker, 0.5);
 
 		if (slider->horizontal)
-			pattern = cairo_pattern_create_linear (0, ty, 0, ty + th);
+			equinox_gradient_init (&gradient, 0, ty, 0, ty + th);
 		else
-			pattern = cairo_pattern_create_linear (tx, 0, tx + tw, 0);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &darker, 0.5);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &fill, 0.5);
+			equinox_gradient_init (&gradient, tx, 0, tx + tw, 0);
+		equinox_gradient_add_rgba (&gradient, 0.0, &darker, 0.5);
+		equinox_gradient_add_rgba (&gradient, 1.0, &fill, 0.5);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, fx, fy, fw, fh, ROUNDNESS, EQX_CORNER_ALL, pattern);
 	}
 
-	equinox_draw_etched_shadow (cr, tx - 0.5, ty - 0.5, tw + 1, th + 1, ROUNDNESS + 1, EQX_CORNER_ALL, &widget->parentbg, 0.9);
+	equinox_draw_etched_shadow (cr, tx - 0.5, ty - 0.5, tw + 1, th + 1, ROUNDNESS + 1, EQX_CORNER_ALL, equinox_params_parentbg (widget), 0.9);
 
 }
 
@@ -722,9 +1016,10 @@ void equinox_draw_scale_slider (cairo_t * cr,
 	EquinoxRGB fill;
 	EquinoxRGB highlight, mid_highlight, fill_darker;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 	int cx, cy, radius;
 
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 
 	// Rotate if not horizontal
 	if (!(slider->horizontal)) {
@@ -741,14 +1036,14 @@ void equinox_draw_scale_slider (cairo_t * cr,
 
     fill  = colors->bg[widget->state_type];
 	//equinox_shade (&fill, &border, 0.7);
-	equinox_mix_color (&widget->parentbg, &fill, 0.45, &border);
+	equinox_mix_color (equinox_params_parentbg (widget), &fill, 0.45, &border);
 	double lightness_sum = equinox_get_lightness(&fill) + lightness;
 	double lightness_delta = equinox_get_lightness(&fill) - lightness;
 	equinox_shade (&border, &border, 0.82 - lightness_delta * lightness_sum);
 
 	// Shadow
 	EquinoxRGB shadow;
-	equinox_shade (&widget->parentbg, &shadow, 0.65);
+	equinox_shade (equinox_params_parentbg (widget), &shadow, 0.65);
 	equinox_arc (cr, EQX_CAIRO_STROKE, slider->horizontal ? cx : cx + 0.5, slider->horizontal ? cy + 0.5 : cy, radius - 1.0, 0, M_PI * 2, &shadow, 0.32);
 	equinox_arc (cr, EQX_CAIRO_STROKE, slider->horizontal ? cx : cx + 1.5, slider->horizontal ? cy + 1.5 : cy, radius - 0.5, 0, M_PI * 2, &shadow, 0.06);
 
@@ -780,10 +1075,11 @@ void equinox_draw_scale_slider (cairo_t * cr,
 		cairo_translate(cr, ex, ey);  // make (ex, ey) == (0, 0)
 		cairo_scale(cr, ew / 2.0, eh / 2.0);  // for width: ew / 2.0 == 1.0 and for height: eh / 2.0 == 1.0
 		equinox_shade (&fill, &highlight, lightness < 0.5 ? 1.8 : 1.2);
-		pattern = cairo_pattern_create_linear (0, 0, slider->horizontal ? 0 : 1.0, slider->horizontal ? 1.0 : 0);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, 0.6);
-		equinox_pattern_add_color_rgba (pattern, 0.8, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 0, 0, slider->horizontal ? 0 : 1.0, slider->horizontal ? 1.0 : 0);
+		equinox_gradient_add_rgba (&gradient, 0.0, &highlight, 0.6);
+		equinox_gradient_add_rgba (&gradient, 0.8, &highlight, 0.0);
 		cairo_arc(cr, 0.0, 0.0, 1.0, 0.0, 2 * M_PI);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		cairo_set_source( cr, pattern);
 		cairo_fill_preserve(cr);
 		cairo_restore(cr);
@@ -806,23 +1102,26 @@ void equinox_draw_scale_slider (cairo_t * cr,
 		equinox_shade (&fill_darker, &fill_darker, 0.95);
 		// Fill
 		double r = radius - 4;
-		pattern = cairo_pattern_create_linear (cx - r, cy - r, slider->horizontal ? cx - r : cx + r, slider->horizontal ? cy + r : cy - r);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &fill_darker);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &fill_darker, 0.5);
+		equinox_gradient_init (&gradient, cx - r, cy - r, slider->horizontal ? cx - r : cx + r, slider->horizontal ? cy + r : cy - r);
+		equinox_gradient_add_rgb (&gradient, 0.0, &fill_darker);
+		equinox_gradient_add_rgba (&gradient, 1.0, &fill_darker, 0.5);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_FILL, cx, cy, r, 0, M_PI * 2, pattern);
 		// Border
 		r = radius - 4.5;
-		pattern = cairo_pattern_create_linear (cx - r, cy - r, slider->horizontal ? cx - r : cx + r, slider->horizontal ? cy + r : cy - r);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &border, 0.95);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.6);
+		equinox_gradient_init (&gradient, cx - r, cy - r, slider->horizontal ? cx - r : cx + r, slider->horizontal ? cy + r : cy - r);
+		equinox_gradient_add_rgba (&gradient, 0.0, &border, 0.95);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.6);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_STROKE, cx, cy, r, 0, M_PI * 2, pattern);
 	}
 
 	// Stroke highlight
 	equinox_shade (&fill, &highlight, 1.35);
-	pattern = cairo_pattern_create_linear (3, 3, slider->horizontal ? 3 : width - 6, slider->horizontal ? height - 6 : 3);
-	equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, (scalesliderstyle == 1) ? 0.0 : 1.0);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, (scalesliderstyle == 1) ? 0.5 : 0.0);
+	equinox_gradient_init (&gradient, 3, 3, slider->horizontal ? 3 : width - 6, slider->horizontal ? height - 6 : 3);
+	equinox_gradient_add_rgba (&gradient, 0.0, &highlight, (scalesliderstyle == 1) ? 0.0 : 1.0);
+	equinox_gradient_add_rgba (&gradient, 1.0, &highlight, (scalesliderstyle == 1) ? 0.5 : 0.0);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_arc_gradient (cr, EQX_CAIRO_STROKE, cx, cy, radius - 2.5, 0, M_PI * 2, pattern);
 
 	// Border
@@ -839,15 +1138,17 @@ void equinox_draw_scale_slider (cairo_t * cr,
 		} else {*/
 			equinox_shade_shift (&border, &border_darker, 0.5);
 		//}
-		pattern = cairo_pattern_create_linear (2, 2, slider->horizontal ? 2 : width - 4, slider->horizontal ? height - 4 : 2);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &border);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &border_darker);
+		equinox_gradient_init (&gradient, 2, 2, slider->horizontal ? 2 : width - 4, slider->horizontal ? height - 4 : 2);
+		equinox_gradient_add_rgb (&gradient, 0.0, &border);
+		equinox_gradient_add_rgb (&gradient, 1.0, &border_darker);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_STROKE, cx, cy, radius - 1.5, 0, M_PI * 2, pattern);
 	} else {
 		equinox_shade_shift (&border, &border_darker, 0.5);
-		pattern = cairo_pattern_create_linear (2, 2, slider->horizontal ? 2 : width - 4, slider->horizontal ? height - 4 : 2);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &border);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &border_darker);
+		equinox_gradient_init (&gradient, 2, 2, slider->horizontal ? 2 : width - 4, slider->horizontal ? height - 4 : 2);
+		equinox_gradient_add_rgb (&gradient, 0.0, &border);
+		equinox_gradient_add_rgb (&gradient, 1.0, &border_darker);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_STROKE, cx, cy, radius - 1.5, 0, M_PI * 2, pattern);
 		/*if (widget->focus) {
 			equinox_mix_color (&border, &colors->spot[1], 0.85, &border);
@@ -871,7 +1172,8 @@ equinox_draw_progressbar_trough (cairo_t * cr,
 {
 	EquinoxRGB bg_darker;
 	cairo_pattern_t *pattern;
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	EquinoxGradient gradient;
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 
 	if (progressbar->orientation == EQX_ORIENTATION_LEFT_TO_RIGHT) {
 		rotate_mirror_translate (cr, 0, x, y, FALSE, FALSE);
@@ -896,7 +1198,7 @@ equinox_draw_progressbar_trough (cairo_t * cr,
 
 	int roundness = MIN (widget->curvature, (height-4.0)/2.0);
 
-	cairo_set_source_rgb (cr, widget->parentbg.r, widget->parentbg.g, widget->parentbg.b);
+	cairo_set_source_rgb (cr, (*equinox_params_parentbg (widget)).r, (*equinox_params_parentbg (widget)).g, (*equinox_params_parentbg (widget)).b);
 	cairo_rectangle(cr, x, y, width, height);
 	cairo_fill(cr);
 
@@ -925,46 +1227,82 @@ equinox_draw_progressbar_trough (cairo_t * cr,
 	//equinox_mix_color (&bg_darker, &highlight, 0.50, &highlight);
 	//equinox_mix_color (&bg_darker, &highlight, 0.7, &highlight_mid);
 
-	pattern = cairo_pattern_create_linear (0, 0, 0, height);
+	equinox_gradient_init (&gradient, 0, 0, 0, height);
 	if (progressbarstyle == 1) {
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &highlight_mid);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &bg_darker);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &colors->bg[0]);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgb (&gradient, 0.5, &highlight_mid);
+		equinox_gradient_add_rgb (&gradient, 0.5, &bg_darker);
+		equinox_gradient_add_rgb (&gradient, 1.0, &colors->bg[0]);
 	} else {
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight_mid);
-		equinox_pattern_add_color_rgb (pattern, 0.3, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &bg_darker);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight_mid);
+		equinox_gradient_add_rgb (&gradient, 0.3, &highlight);
+		equinox_gradient_add_rgb (&gradient, 1.0, &bg_darker);
 	}
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 2, 1, width - 4, height - 2, roundness+1, widget->corners, pattern);
 
 	//highlight
 	if (progressbarstyle == 0) {
 		equinox_shade (&colors->bg[0], &highlight, 1.5);
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, 0.6);
-		equinox_pattern_add_color_rgba (pattern, 0.3, &highlight, 0.2);
-		equinox_pattern_add_color_rgba (pattern, 0.75, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &highlight, 0.6);
+		equinox_gradient_add_rgba (&gradient, 0.3, &highlight, 0.2);
+		equinox_gradient_add_rgba (&gradient, 0.75, &highlight, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 2.5, 2, width - 5, height-4, roundness, widget->corners, pattern);
 	}
 }
 
+/* One period of the diagonal stripes: a stripe_width wide tile holding a
+ * single parallelogram.  The neighbours are drawn too so the antialiased
+ * corners wrap around when the tile repeats. */
+static cairo_pattern_t *
+equinox_create_progressbar_stripes (const EquinoxColors * colors, int height, int progressbarstyle)
+{
+	double stroke_width = height * 2;
+	double lightness = colors->derived.spot_lightness;
+	cairo_surface_t *surface;
+	cairo_pattern_t *pattern;
+	cairo_t *cr;
+	int i;
+
+	surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, MAX (stroke_width, 1), MAX (height, 1));
+	cr = cairo_create (surface);
+
+	for (i = -1; i <= 1; i++) {
+		cairo_move_to (cr, stroke_width / 2 + i * stroke_width, 0);
+		cairo_line_to (cr, stroke_width + i * stroke_width, 0);
+		cairo_line_to (cr, stroke_width / 2 + i * stroke_width, height);
+		cairo_line_to (cr, i * stroke_width, height);
+	}
+	equinox_set_source_rgba (cr, &colors->derived.spot_stripe, (progressbarstyle == 1 ? 1.0 : 0.7) - lightness*0.6);
+	cairo_fill (cr);
+	cairo_destroy (cr);
+
+	pattern = cairo_pattern_create_for_surface (surface);
+	cairo_pattern_set_extend (pattern, CAIRO_EXTEND_REPEAT);
+	cairo_surface_destroy (surface);
+
+	return pattern;
+}
+
 void
 equinox_draw_progressbar_fill (cairo_t * cr,
 			      const EquinoxColors * colors,
 			      const WidgetParameters * widget,
 			      const ProgressBarParameters * progressbar,
 			      int x, int y, int width, int height,
-			      gint offset, int progressbarstyle) {
-	double tile_pos = 0;
+			      gdouble phase, int progressbarstyle) {
 	double stroke_width;
 	int x_step, tmp;
 
 	EquinoxRGB shadow, highlight = colors->bg[GTK_STATE_PRELIGHT];
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
+	cairo_matrix_t matrix;
 
-	double lightness = equinox_get_lightness(&colors->spot[1]);
-	double parent_lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = colors->derived.spot_lightness;
+	double parent_lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 
 	if (progressbar->orientation == EQX_ORIENTATION_LEFT_TO_RIGHT)
 		rotate_mirror_translate (cr, 0, x, y, FALSE, FALSE);
@@ -998,10 +1336,11 @@ equinox_draw_progressbar_fill (cairo_t * cr,
 	}
 
 	stroke_width = height * 2;
-	x_step = (((float) stroke_width / 10) * offset);
+	/* phase is how far the stripes are through their period */
+	x_step = (int) (stroke_width * (1.0 - phase));
 
 	// Drop shadow
-	equinox_shade(&widget->parentbg, &shadow, 0.6);
+	equinox_shade(equinox_params_parentbg (widget), &shadow, 0.6);
 	equinox_rounded_rectangle (cr, EQX_CAIRO_FILL, 2, 1, width-2, height-1, roundness+1, widget->corners, &shadow, 0.2);
 
 
@@ -1011,63 +1350,54 @@ equinox_draw_progressbar_fill (cairo_t * cr,
 
 	cairo_rectangle (cr, 2, 1, width-4, height-2);
 
-	EquinoxRGB spot_darker, spot_lighter;
-
-	equinox_shade_shift (&colors->spot[1], &spot_darker, 0.75);
-	equinox_shade_shift (&colors->spot[1], &spot_lighter, 1.08);
-
-	pattern = cairo_pattern_create_linear (0, 0, 0, height);
+	equinox_gradient_init (&gradient, 0, 0, 0, height);
 	if (progressbarstyle == 0) { //Gradient highlight
-		equinox_pattern_add_color_rgb (pattern, 0.0, &spot_lighter);
-		equinox_pattern_add_color_rgb (pattern, 0.45, &colors->spot[1]);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &spot_darker);
+		equinox_gradient_add_rgb (&gradient, 0.0, &colors->derived.spot_lighter);
+		equinox_gradient_add_rgb (&gradient, 0.45, &colors->spot[1]);
+		equinox_gradient_add_rgb (&gradient, 1.0, &colors->derived.spot_darker);
 	} else {
-		equinox_pattern_add_color_rgb (pattern, 0.0, &spot_darker);
-		equinox_pattern_add_color_rgb (pattern, 0.85, &colors->spot[1]);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &spot_lighter);
+		equinox_gradient_add_rgb (&gradient, 0.0, &colors->derived.spot_darker);
+		equinox_gradient_add_rgb (&gradient, 0.85, &colors->spot[1]);
+		equinox_gradient_add_rgb (&gradient, 1.0, &colors->derived.spot_lighter);
 	}
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0.5, 0 + yd, width - 1, height, roundness-1, widget->corners, pattern);
 
 	// Draw strokes
-	while (tile_pos <= width + x_step - 2) {
-		cairo_move_to (cr, stroke_width / 2 - x_step, 0);
-		cairo_line_to (cr, stroke_width - x_step, 0);
-		cairo_line_to (cr, stroke_width / 2 - x_step, height);
-		cairo_line_to (cr, -x_step, height);
+	pattern = equinox_cache_lookup_stripes (colors, height, progressbarstyle);
+	if (pattern == NULL) {
+		pattern = equinox_create_progressbar_stripes (colors, height, progressbarstyle);
+		equinox_cache_insert_stripes (colors, height, progressbarstyle, pattern);
+	} else
+		cairo_pattern_reference (pattern);
 
-		cairo_translate (cr, stroke_width, 0);
-		tile_pos += stroke_width;
-	}
-	equinox_shade_shift (&spot_darker, &spot_darker, 0.95);
-	equinox_set_source_rgba (cr, &spot_darker, (progressbarstyle == 1 ? 1.0 : 0.7) - lightness*0.6);
+	cairo_matrix_init_translate (&matrix, x_step, 0);
+	cairo_pattern_set_matrix (pattern, &matrix);
+	cairo_set_source (cr, pattern);
+	cairo_rectangle (cr, 0, 0, width, height);
 	cairo_fill (cr);
+	cairo_pattern_destroy (pattern);
 
 	cairo_restore (cr);
 
 	//Glassy highlight
 	if (progressbarstyle == 1) {
-		equinox_shade_shift (&colors->spot[1], &highlight, 1.25 + (1.0 - lightness) * 0.25);
-		equinox_shade_shift (&colors->spot[1], &shadow, 0.7);
-
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, 0.55);
-		equinox_pattern_add_color_rgba (pattern, 0.5, &highlight, 0.35);
-		equinox_pattern_add_color_rgba (pattern, 0.5, &highlight, 0.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.5);
+		highlight = colors->derived.spot_highlight;
+
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &highlight, 0.55);
+		equinox_gradient_add_rgba (&gradient, 0.5, &highlight, 0.35);
+		equinox_gradient_add_rgba (&gradient, 0.5, &highlight, 0.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.5);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 1, 1 + yd, width-2, height-2*yd, roundness-0.5, widget->corners, pattern);
 	}
 
 	// Border
-	EquinoxRGB border_darker, border_lighter;
-	equinox_shade_shift (&colors->spot[2], &border_darker, 1.1);
-	if (parent_lightness < 0.4) {
-		equinox_shade_shift (&colors->spot[1], &border_lighter, 1.4);
-	} else {
-		equinox_shade_shift (&colors->spot[2], &border_lighter, 1.25);
-	}
-	pattern = cairo_pattern_create_linear (0, 0.5, 0, height - 0.5);
-	equinox_pattern_add_color_rgba (pattern, 0.0, &border_lighter, lightness * 0.5);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &border_darker, lightness * 0.75);
+	equinox_gradient_init (&gradient, 0, 0.5, 0, height - 0.5);
+	equinox_gradient_add_rgba (&gradient, 0.0, &colors->derived.spot_border_lighter[parent_lightness < 0.4 ? 0 : 1], lightness * 0.5);
+	equinox_gradient_add_rgba (&gradient, 1.0, &colors->derived.spot_border_darker, lightness * 0.75);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 2.5, 1.5 + yd, width - 5, height - 2, roundness-0.5, widget->corners, pattern);
 }
 
@@ -1078,15 +1408,17 @@ void equinox_draw_menubar (cairo_t * cr,
 
 	EquinoxRGB shadow, highlight;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	cairo_translate (cr, x, y);
 	cairo_rectangle (cr, 0, 0, width, height);
 
 	// Gradient menubar
 	if (menubarstyle == 1) {
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &colors->bg[0]);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &colors->shade[2]);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &colors->bg[0]);
+		equinox_gradient_add_rgb (&gradient, 1.0, &colors->shade[2]);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 	} else {
 		//flat menubar
@@ -1103,19 +1435,21 @@ void equinox_draw_menubar (cairo_t * cr,
 	}
 	if (menubarborders >= 2) {
 		equinox_shade (&colors->bg[GTK_STATE_NORMAL], &shadow, 0.9);
-		pattern = cairo_pattern_create_linear (0, 0, width/2, 0);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &shadow, 1.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &shadow, 0.0);
+		equinox_gradient_init (&gradient, 0, 0, width/2, 0);
+		equinox_gradient_add_rgba (&gradient, 0.0, &shadow, 1.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &shadow, 0.0);
 		cairo_move_to (cr, 0, 0.5);
 		cairo_line_to (cr, width/2, 0.5);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		cairo_set_source (cr, pattern);
 		cairo_stroke (cr);
 		equinox_shade (&colors->bg[GTK_STATE_NORMAL], &highlight, 1.10);
-		pattern = cairo_pattern_create_linear (0, 1, width/2, 1);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, 1.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 0, 1, width/2, 1);
+		equinox_gradient_add_rgba (&gradient, 0.0, &highlight, 1.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.0);
 		cairo_move_to (cr, 0, 1.5);
 		cairo_line_to (cr, width/2, 1.5);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		cairo_set_source (cr, pattern);
 		cairo_stroke (cr);
 	}
@@ -1137,10 +1471,12 @@ void equinox_draw_panel (cairo_t * cr,
 
 	// Gradient panel
 	//if (menubarstyle == 1) {
-		cairo_pattern_t *pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &color2 );
-		equinox_pattern_add_color_rgb (pattern, 1.0, &color);
+		cairo_pattern_t *pattern;
+		EquinoxGradient gradient;
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &color2 );
+		equinox_gradient_add_rgb (&gradient, 1.0, &color);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 	//} else {
 		//flat panel
@@ -1231,9 +1567,12 @@ void equinox_draw_frame (cairo_t * cr,
 		equinox_rounded_rectangle (cr, EQX_CAIRO_STROKE, 2.5, 3, width-6, height - 6, curvature - 0.5, widget->corners, &shadow, 0.05);
 
 		// Bottom Highlight
-		cairo_pattern_t *pattern = cairo_pattern_create_linear (0, 0, 0, height-1);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &colors->bg[GTK_STATE_NORMAL]);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &highlight);
+		cairo_pattern_t *pattern;
+		EquinoxGradient gradient;
+		equinox_gradient_init (&gradient, 0, 0, 0, height-1);
+		equinox_gradient_add_rgb (&gradient, 0.5, &colors->bg[GTK_STATE_NORMAL]);
+		equinox_gradient_add_rgb (&gradient, 1.0, &highlight);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 0, 0, width - 1, height - 1, curvature + 1, widget->corners, pattern);
 
 	} else {
@@ -1285,9 +1624,10 @@ equinox_draw_tab (cairo_t * cr,
 
 	equinox_shade (&colors->bg[widget->state_type], &border1, 0.68);
 
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	// Make the tabs slightly bigger than they should be, to create a gap
 	if (tab->gap_side == EQX_GAP_TOP || tab->gap_side == EQX_GAP_BOTTOM) {
@@ -1330,17 +1670,19 @@ equinox_draw_tab (cairo_t * cr,
 		EquinoxRGB fill_shaded1, fill_shaded2;
 		equinox_shade (fill, &fill_shaded1, 0.925);
 		equinox_shade (fill, &fill_shaded2, 0.90);
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &fill_shaded1);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &fill_shaded2);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &fill_shaded1);
+		equinox_gradient_add_rgb (&gradient, 0.5, &fill_shaded2);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0.5, 0.5, width - 2, height, roundness, EQX_CORNER_TOPLEFT | EQX_CORNER_TOPRIGHT, pattern);
 
 		// Shadow
 		EquinoxRGB shadowing;
 		equinox_shade (&border1, &shadowing, 0.90);
-		pattern = cairo_pattern_create_linear (0, height-4, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &shadowing, 0.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &shadowing, 0.26);
+		equinox_gradient_init (&gradient, 0, height-4, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &shadowing, 0.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &shadowing, 0.26);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0.5, 0.5, width - 1, height - 2, roundness-1, EQX_CORNER_TOPLEFT | EQX_CORNER_TOPRIGHT, pattern);
 
 	} else {
@@ -1360,20 +1702,22 @@ equinox_draw_tab (cairo_t * cr,
 
 		// Draw Fill and shade
 	    equinox_shade (fill, &highlight, 1.06);
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.5, fill);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgb (&gradient, 0.5, fill);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0.5, 0.5, width - 2, height + 3, roundness, EQX_CORNER_TOPLEFT | EQX_CORNER_TOPRIGHT, pattern);
 	}
 
 	cairo_restore (cr);
 
 	// Highlight
-	equinox_shade (fill, &highlight, equinox_get_lightness (&colors->bg[GTK_STATE_NORMAL]) > 0.6 ? 1.125 : 1.25);
-	pattern = cairo_pattern_create_linear (0, 0, 0, height);
-	equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, 0.5);
-	equinox_pattern_add_color_rgba (pattern, 0.5, &highlight, 0.15);
-	equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.0);
+	equinox_shade (fill, &highlight, colors->derived.bg_lightness > 0.6 ? 1.125 : 1.25);
+	equinox_gradient_init (&gradient, 0, 0, 0, height);
+	equinox_gradient_add_rgba (&gradient, 0.0, &highlight, 0.5);
+	equinox_gradient_add_rgba (&gradient, 0.5, &highlight, 0.15);
+	equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.0);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 1, 1, width - 3, height, roundness-1, EQX_CORNER_TOPLEFT | EQX_CORNER_TOPRIGHT, pattern);
 
 	// Border
@@ -1384,7 +1728,7 @@ equinox_draw_tab (cairo_t * cr,
 
 	// Focus
 	if (widget->focus && !widget->active) {
-		double offset = equinox_get_lightness(&colors->bg[GTK_STATE_NORMAL]) > 0.6 ? 0 : 1;
+		double offset = colors->derived.bg_lightness > 0.6 ? 0 : 1;
 
 		cairo_rectangle(cr, 0, 0, width, height);
 		cairo_clip(cr);
@@ -1394,14 +1738,16 @@ equinox_draw_tab (cairo_t * cr,
 		} else {
 			equinox_shade (&colors->spot[1], &focus, 0.8);
 		}
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &focus, 1.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &focus, 0.0);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &focus, 1.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &focus, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, offset, offset, width - 1 - (2*offset), height + (2*roundness), roundness, EQX_CORNER_TOPLEFT | EQX_CORNER_TOPRIGHT, pattern);
 		focus = colors->spot[1];
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &focus, 0.3);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &focus, 0.0);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &focus, 0.3);
+		equinox_gradient_add_rgba (&gradient, 1.0, &focus, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, offset+1, offset+1, width - 3 - (2*offset), height + (2*roundness), roundness, EQX_CORNER_TOPLEFT | EQX_CORNER_TOPRIGHT, pattern);
 	}
 }
@@ -1414,10 +1760,11 @@ equinox_draw_separator (cairo_t * cr,
 		       int x, int y, int width, int height, int separatorstyle)
 {
 
-	EquinoxRGB dark = widget->parentbg;
+	EquinoxRGB dark = (*equinox_params_parentbg (widget));
 	EquinoxRGB light;
 
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	equinox_shade (&dark, &light, separatorstyle >= 2 ? 1.5 : 1.15);
 	equinox_shade (&dark, &dark, 0.68);
@@ -1430,11 +1777,12 @@ equinox_draw_separator (cairo_t * cr,
 			cairo_move_to (cr, 0.0, 0.0);
 			cairo_line_to (cr, width, 0.0);
 			if (separatorstyle == 1 || separatorstyle == 3) {
-				pattern = cairo_pattern_create_linear (0, 0, width, 0);
-				equinox_pattern_add_color_rgba (pattern, 0.0, &dark, 0.0);
-				equinox_pattern_add_color_rgba (pattern, 0.25, &dark, 0.6);
-				equinox_pattern_add_color_rgba (pattern, 0.75, &dark, 0.6);
-				equinox_pattern_add_color_rgba (pattern, 1.0, &dark, 0.0);
+				equinox_gradient_init (&gradient, 0, 0, width, 0);
+				equinox_gradient_add_rgba (&gradient, 0.0, &dark, 0.0);
+				equinox_gradient_add_rgba (&gradient, 0.25, &dark, 0.6);
+				equinox_gradient_add_rgba (&gradient, 0.75, &dark, 0.6);
+				equinox_gradient_add_rgba (&gradient, 1.0, &dark, 0.0);
+				pattern = equinox_gradient_get_pattern (&gradient);
 				cairo_set_source (cr, pattern);
 			} else {
 				cairo_set_source_rgba (cr, dark.r, dark.g, dark.b, 0.6);
@@ -1445,11 +1793,12 @@ equinox_draw_separator (cairo_t * cr,
 			cairo_move_to (cr, 0.0, 1.0);
 			cairo_line_to (cr, width, 1.0);
 			if (separatorstyle == 1 || separatorstyle == 2) {
-				pattern = cairo_pattern_create_linear (0, 1, width, 1);
-				equinox_pattern_add_color_rgba (pattern, 0.0, &light, 0.0);
-				equinox_pattern_add_color_rgba (pattern, 0.25, &light, 0.6);
-				equinox_pattern_add_color_rgba (pattern, 0.75, &light, 0.6);
-				equinox_pattern_add_color_rgba (pattern, 1.0, &light, 0.0);
+				equinox_gradient_init (&gradient, 0, 1, width, 1);
+				equinox_gradient_add_rgba (&gradient, 0.0, &light, 0.0);
+				equinox_gradient_add_rgba (&gradient, 0.25, &light, 0.6);
+				equinox_gradient_add_rgba (&gradient, 0.75, &light, 0.6);
+				equinox_gradient_add_rgba (&gradient, 1.0, &light, 0.0);
+				pattern = equinox_gradient_get_pattern (&gradient);
 				cairo_set_source (cr, pattern);
 			} else {
 				cairo_set_source_rgba (cr, light.r, light.g, light.b, 0.6);
@@ -1461,16 +1810,17 @@ equinox_draw_separator (cairo_t * cr,
 			cairo_move_to (cr, 0.0, 0.0);
 			cairo_line_to (cr, 0.0, height);
 			if (separatorstyle == 1 || separatorstyle == 3) {
-				pattern = cairo_pattern_create_linear (0, 0, 0, height);
-				equinox_pattern_add_color_rgba (pattern, 0.0, &dark, 0.0);
+				equinox_gradient_init (&gradient, 0, 0, 0, height);
+				equinox_gradient_add_rgba (&gradient, 0.0, &dark, 0.0);
 				if (separator->inToolbar) {
-					equinox_pattern_add_color_rgba (pattern, 0.45, &dark, 0.7);
-					equinox_pattern_add_color_rgba (pattern, 0.55, &dark, 0.7);
+					equinox_gradient_add_rgba (&gradient, 0.45, &dark, 0.7);
+					equinox_gradient_add_rgba (&gradient, 0.55, &dark, 0.7);
 				} else {
-					equinox_pattern_add_color_rgba (pattern, 0.1, &dark, 0.6);
-					equinox_pattern_add_color_rgba (pattern, 0.9, &dark, 0.6);
+					equinox_gradient_add_rgba (&gradient, 0.1, &dark, 0.6);
+					equinox_gradient_add_rgba (&gradient, 0.9, &dark, 0.6);
 				}
-				equinox_pattern_add_color_rgba (pattern, 1.0, &dark, 0.0);
+				equinox_gradient_add_rgba (&gradient, 1.0, &dark, 0.0);
+				pattern = equinox_gradient_get_pattern (&gradient);
 				cairo_set_source (cr, pattern);
 			} else {
 				cairo_set_source_rgba (cr, dark.r, dark.g, dark.b, 0.6);
@@ -1481,16 +1831,17 @@ equinox_draw_separator (cairo_t * cr,
 			cairo_move_to (cr, 1.0, 0.0);
 			cairo_line_to (cr, 1.0, height);
 			if (separatorstyle == 1 || separatorstyle == 2) {
-				pattern = cairo_pattern_create_linear (1, 0, 1, height);
-				equinox_pattern_add_color_rgba (pattern, 0.0, &light, 0.0);
+				equinox_gradient_init (&gradient, 1, 0, 1, height);
+				equinox_gradient_add_rgba (&gradient, 0.0, &light, 0.0);
 				if (separator->inToolbar) {
-					equinox_pattern_add_color_rgba (pattern, 0.45, &light, 0.7);
-					equinox_pattern_add_color_rgba (pattern, 0.55, &light, 0.7);
+					equinox_gradient_add_rgba (&gradient, 0.45, &light, 0.7);
+					equinox_gradient_add_rgba (&gradient, 0.55, &light, 0.7);
 				} else {
-					equinox_pattern_add_color_rgba (pattern, 0.9, &light, 0.6);
-					equinox_pattern_add_color_rgba (pattern, 0.1, &light, 0.6);
+					equinox_gradient_add_rgba (&gradient, 0.9, &light, 0.6);
+					equinox_gradient_add_rgba (&gradient, 0.1, &light, 0.6);
 				}
-				equinox_pattern_add_color_rgba (pattern, 1.0, &light, 0.0);
+				equinox_gradient_add_rgba (&gradient, 1.0, &light, 0.0);
+				pattern = equinox_gradient_get_pattern (&gradient);
 				cairo_set_source (cr, pattern);
 			} else {
 				cairo_set_source_rgba (cr, light.r, light.g, light.b, 0.6);
@@ -1515,38 +1866,33 @@ equinox_draw_list_view_header (cairo_t * cr,
 	if (header->sorted) {
 		fill = colors->bg[GTK_STATE_ACTIVE];
 		//If prelight match the sorted row prelight brightness with that of normal prelight
-		if (widget->state_type == GTK_STATE_PRELIGHT) {
-			//Increase lightness for sorted prelight by the difference between prelight and nomral lightness
-			double prelight_lightness = equinox_get_lightness (&colors->bg[GTK_STATE_PRELIGHT]);
-			double normal_lightness = equinox_get_lightness (&colors->bg[GTK_STATE_NORMAL]);
-			equinox_set_lightness (&fill, equinox_get_lightness(&fill) + prelight_lightness - normal_lightness);
-		}
+		if (widget->state_type == GTK_STATE_PRELIGHT)
+			fill = colors->derived.header_sorted_prelight;
 	}
 	else {
 		fill = colors->bg[widget->state_type];
 	}
-#ifdef HAVE_ANIMATION
-	EquinoxRGB fill_old = colors->bg[widget->prev_state_type];
+	/* headers are not cached, so they still mix their colours while
+	 * they animate instead of drawing both ends */
+	if (widget->trans < 1.0) {
+		EquinoxRGB fill_old = colors->bg[widget->prev_state_type];
 
-	if (header->sorted && widget->prev_state_type != GTK_STATE_PRELIGHT)
-		fill_old = colors->bg[GTK_STATE_ACTIVE];
+		if (header->sorted && widget->prev_state_type != GTK_STATE_PRELIGHT)
+			fill_old = colors->bg[GTK_STATE_ACTIVE];
 
-	if (header->sorted && widget->prev_state_type == GTK_STATE_PRELIGHT) {
-		fill_old = colors->bg[GTK_STATE_ACTIVE];
-		//Increase lightness for sorted prelight by the difference between prelight and nomral lightness
-		double prelight_lightness = equinox_get_lightness (&colors->bg[GTK_STATE_PRELIGHT]);
-		double normal_lightness = equinox_get_lightness (&colors->bg[GTK_STATE_NORMAL]);
-		equinox_set_lightness (&fill_old, equinox_get_lightness(&fill_old) + prelight_lightness - normal_lightness);
+		if (header->sorted && widget->prev_state_type == GTK_STATE_PRELIGHT) {
+			fill_old = colors->derived.header_sorted_prelight;
 
-		equinox_match_lightness (&colors->bg[GTK_STATE_PRELIGHT], &fill_old);
+			equinox_match_lightness (&colors->bg[GTK_STATE_PRELIGHT], &fill_old);
+		}
+		equinox_mix_color (&fill_old, &fill, widget->trans, &fill);
 	}
-	equinox_mix_color (&fill_old, &fill, widget->trans, &fill);
-#endif
 	EquinoxRGB *border = (EquinoxRGB *) &colors->shade[4];
 
 	cairo_translate (cr, x, y);
 
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 	EquinoxRGB fill_darker, highlight, highlight_mid;
 
 
@@ -1559,11 +1905,12 @@ equinox_draw_list_view_header (cairo_t * cr,
 		equinox_mix_color (&fill_darker, &highlight, 0.4, &highlight_mid); // 0.55
 
 		//Draw the fill
-		pattern = cairo_pattern_create_linear (0, 0, 0, height-1);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &highlight_mid);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &fill_darker);
-		equinox_pattern_add_color_rgb (pattern, 0.90, &fill);
+		equinox_gradient_init (&gradient, 0, 0, 0, height-1);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgb (&gradient, 0.5, &highlight_mid);
+		equinox_gradient_add_rgb (&gradient, 0.5, &fill_darker);
+		equinox_gradient_add_rgb (&gradient, 0.90, &fill);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 
 		//Inner glow
@@ -1599,18 +1946,19 @@ equinox_draw_list_view_header (cairo_t * cr,
 		equinox_shade_shift (&fill, &fill_darker, 0.92);
 
 		//Draw the fill
-		pattern = cairo_pattern_create_linear (0, 0, 0, height-1);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.56, &fill);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &fill_darker);
+		equinox_gradient_init (&gradient, 0, 0, 0, height-1);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgb (&gradient, 0.56, &fill);
+		equinox_gradient_add_rgb (&gradient, 1.0, &fill_darker);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 
 	}
 
 	// Draw bottom border
 	EquinoxRGB shadow;
-	double widget_lightness = equinox_get_lightness (&colors->bg[GTK_STATE_NORMAL]);
-	double parent_lightness = equinox_get_lightness (&widget->parentbg);
+	double widget_lightness = colors->derived.bg_lightness;
+	double parent_lightness = equinox_get_lightness (equinox_params_parentbg (widget));
 	equinox_shade (border, &shadow, widget_lightness - parent_lightness > 0.3 ? 0.75 - (widget_lightness - parent_lightness) : 0.9);
 	cairo_move_to (cr, 0.0, height - 0.5);
 	cairo_line_to (cr, width, height - 0.5);
@@ -1640,11 +1988,12 @@ equinox_draw_list_view_header (cairo_t * cr,
 		if (header->order != EQX_ORDER_LAST) {
 			equinox_shade (border, &separator, 0.45);
 
-			pattern = cairo_pattern_create_linear (0, 0, 0, height);
-			cairo_pattern_add_color_stop_rgba (pattern, 0.0, separator.r, separator.g, separator.b, 0.35);
-			cairo_pattern_add_color_stop_rgba (pattern, 0.3, separator.r, separator.g, separator.b, 0.70);
-			cairo_pattern_add_color_stop_rgba (pattern, 0.6, separator.r, separator.g, separator.b, 0.70);
-			cairo_pattern_add_color_stop_rgba (pattern, 1.0, separator.r, separator.g, separator.b, 0.25);
+			equinox_gradient_init (&gradient, 0, 0, 0, height);
+			equinox_gradient_add_rgba (&gradient, 0.0, &separator, 0.35);
+			equinox_gradient_add_rgba (&gradient, 0.3, &separator, 0.70);
+			equinox_gradient_add_rgba (&gradient, 0.6, &separator, 0.70);
+			equinox_gradient_add_rgba (&gradient, 1.0, &separator, 0.25);
+			pattern = equinox_gradient_get_pattern (&gradient);
 			cairo_set_source (cr, pattern);
 			//cairo_set_source_rgba (cr, separator.r, separator.g, separator.b, 0.52);
 			cairo_move_to (cr, width -0.5, 0.5);
@@ -1681,13 +2030,16 @@ equinox_draw_toolbar (cairo_t * cr,
 
     cairo_translate (cr, x, y);
 
-    cairo_pattern_t *pattern = cairo_pattern_create_linear (0, 0, 0, height);
+    cairo_pattern_t *pattern;
+    EquinoxGradient gradient;
+    equinox_gradient_init (&gradient, 0, 0, 0, height);
 
 	if ((toolbarstyle == 1) || (toolbarstyle == 3) || (toolbarstyle == 5)) {
 		// Gradient fill
 		equinox_mix_color (&colors->bg[0], &colors->shade[3], 0.8, &fill_shadow);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &colors->shade[2]);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &fill_shadow);
+		equinox_gradient_add_rgb (&gradient, 0.0, &colors->shade[2]);
+		equinox_gradient_add_rgb (&gradient, 1.0, &fill_shadow);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 
 		equinox_shade (&colors->shade[2], &stroke_highlight, 1.12);
@@ -1726,6 +2078,7 @@ equinox_draw_menubar_item (cairo_t * cr,
 {
 
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	cairo_translate (cr, x, y);
 
@@ -1734,15 +2087,17 @@ equinox_draw_menubar_item (cairo_t * cr,
 	if (menubaritemstyle == 0) {
 		equinox_rounded_rectangle (cr, EQX_CAIRO_FILL, 0, 0, width, height, widget->curvature, widget->corners, &colors->bg[GTK_STATE_SELECTED], 1.0);
 	} else if (menubaritemstyle == 1) {
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &colors->bg[GTK_STATE_SELECTED], 0.2);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &colors->bg[GTK_STATE_SELECTED], 1.0);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &colors->bg[GTK_STATE_SELECTED], 0.2);
+		equinox_gradient_add_rgba (&gradient, 1.0, &colors->bg[GTK_STATE_SELECTED], 1.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, widget->curvature, widget->corners, pattern);
 	} else if (menubaritemstyle == 2) {
 		equinox_shade (&colors->bg[GTK_STATE_SELECTED], &fill, 0.6);
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &fill);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &colors->bg[GTK_STATE_SELECTED]);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &fill);
+		equinox_gradient_add_rgb (&gradient, 1.0, &colors->bg[GTK_STATE_SELECTED]);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0, 0, width-1, height, widget->curvature, widget->corners, pattern);
 		EquinoxRGB border;
 		equinox_shade (&colors->bg[GTK_STATE_SELECTED], &border, 0.5);
@@ -1765,44 +2120,50 @@ equinox_draw_menubar_item (cairo_t * cr,
 		cairo_stroke (cr);
 	} else if (menubaritemstyle == 3) {
 		equinox_shade (&colors->bg[GTK_STATE_SELECTED], &fill, 1.15);
-		pattern = cairo_pattern_create_linear (0, height - 4, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &fill);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &colors->bg[GTK_STATE_SELECTED]);
+		equinox_gradient_init (&gradient, 0, height - 4, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &fill);
+		equinox_gradient_add_rgb (&gradient, 1.0, &colors->bg[GTK_STATE_SELECTED]);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0, height - 4, width, 4, widget->curvature, widget->corners, pattern);
 	} else { // old original design
-		EquinoxRGB light = widget->parentbg;
+		EquinoxRGB light = (*equinox_params_parentbg (widget));
 		EquinoxRGB shadow, border;
 		fill = colors->bg[GTK_STATE_SELECTED];
 		equinox_shade_shift (&fill, &border, 0.7);
 		equinox_shade_shift (&light, &light, 1.1);
 		equinox_shade_shift (&fill, &shadow, 0.9);
 		// Item background
-		pattern = cairo_pattern_create_linear (0, 1, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &fill, 0.6);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &fill, 1.0);
+		equinox_gradient_init (&gradient, 0, 1, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &fill, 0.6);
+		equinox_gradient_add_rgba (&gradient, 1.0, &fill, 1.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0, 1, width-1, height-1, widget->curvature, widget->corners, pattern);
 		// Item border
-		pattern = cairo_pattern_create_linear (0, 4, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &border, 0.0);
-		equinox_pattern_add_color_rgba (pattern, 0.5, &border, 0.7);
+		equinox_gradient_init (&gradient, 0, 4, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &border, 0.0);
+		equinox_gradient_add_rgba (&gradient, 0.5, &border, 0.7);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_STROKE, 0.5, 0, width-2, height+1, pattern);
 		if (!in_panel) {
 			// Shadow
-			pattern = cairo_pattern_create_linear (0, 0, 0, height);
-			equinox_pattern_add_color_rgba (pattern, 0.25, &shadow, 0.0);
-			equinox_pattern_add_color_rgba (pattern, 1.0, &shadow, 0.4);
+			equinox_gradient_init (&gradient, 0, 0, 0, height);
+			equinox_gradient_add_rgba (&gradient, 0.25, &shadow, 0.0);
+			equinox_gradient_add_rgba (&gradient, 1.0, &shadow, 0.4);
+			pattern = equinox_gradient_get_pattern (&gradient);
 			equinox_rectangle_gradient (cr, EQX_CAIRO_STROKE, 1.5, 0, width-4, height-1, pattern);
 			// Highlight
-			pattern = cairo_pattern_create_linear (0, 6, 0, height);
-			equinox_pattern_add_color_rgba (pattern, 0.0, &light, 0.0);
-			equinox_pattern_add_color_rgba (pattern, 0.5, &light, 0.4);
+			equinox_gradient_init (&gradient, 0, 6, 0, height);
+			equinox_gradient_add_rgba (&gradient, 0.0, &light, 0.0);
+			equinox_gradient_add_rgba (&gradient, 0.5, &light, 0.4);
+			pattern = equinox_gradient_get_pattern (&gradient);
 			equinox_rectangle_gradient (cr, EQX_CAIRO_STROKE, width-1, 0, 1, height+1, pattern);
 		}
 	}
 }
 
 
-void equinox_draw_menuitem (cairo_t * cr,
+static void
+equinox_draw_menuitem_real (cairo_t * cr,
 		      const EquinoxColors * colors,
 		      const WidgetParameters * widget,
 		      int x, int y, int width, int height, int menuitemstyle) {
@@ -1810,10 +2171,11 @@ void equinox_draw_menuitem (cairo_t * cr,
 	EquinoxRGB fill_shade, fill_light;
 	EquinoxRGB border;
 
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 
 
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	if (menuitemstyle == 1) {
 		EquinoxRGB fill_glow;
@@ -1822,21 +2184,22 @@ void equinox_draw_menuitem (cairo_t * cr,
 
 		cairo_translate (cr, x, y);
 
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &fill);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &fill_glow);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &fill_shade);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &fill);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &fill);
+		equinox_gradient_add_rgb (&gradient, 0.5, &fill_glow);
+		equinox_gradient_add_rgb (&gradient, 0.5, &fill_shade);
+		equinox_gradient_add_rgb (&gradient, 1.0, &fill);
 	} else {
 		equinox_shade_shift (&fill, &fill_shade, 0.92);
 		equinox_shade_shift (&fill, &fill_light, 1.05);
 
 		cairo_translate (cr, x, y);
 
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &fill_light);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &fill_shade);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &fill_light);
+		equinox_gradient_add_rgb (&gradient, 1.0, &fill_shade);
 	}
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, widget->curvature, widget->corners, pattern);
 
 	// Highlight
@@ -1847,11 +2210,12 @@ void equinox_draw_menuitem (cairo_t * cr,
 		cairo_set_source_rgb (cr, border.r, border.g, border.b);
 		cairo_stroke (cr);
 
-		pattern = cairo_pattern_create_linear (0, 1, 0, height - 2);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &border, 1.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &border, 0.0);
+		equinox_gradient_init (&gradient, 0, 1, 0, height - 2);
+		equinox_gradient_add_rgba (&gradient, 0.0, &border, 1.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &border, 0.0);
 		cairo_move_to (cr, 0.5, 1.5);
 		cairo_line_to (cr, 0.5, height - 2);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		cairo_set_source (cr, pattern);
 		cairo_stroke (cr);
 		cairo_move_to (cr, width - 0.5, 1.5);
@@ -1862,9 +2226,10 @@ void equinox_draw_menuitem (cairo_t * cr,
 		EquinoxRGB border_shade;
 		equinox_shade (&fill_shade, &border_shade, lightness < 0.5 ? 0.5 : 0.92);
 		equinox_rounded_rectangle (cr, EQX_CAIRO_STROKE, 0.5, 0.5, width-1, height-1, widget->curvature, widget->corners, &border_shade, 1.0);
-		pattern = cairo_pattern_create_linear (0, 1, 0, height - 2);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &border, 1.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &border, 0.1);
+		equinox_gradient_init (&gradient, 0, 1, 0, height - 2);
+		equinox_gradient_add_rgba (&gradient, 0.0, &border, 1.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &border, 0.1);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 1.5, 1.5, width-3, height-3, widget->curvature - 1, widget->corners, pattern);
 	}
 
@@ -1872,6 +2237,45 @@ void equinox_draw_menuitem (cairo_t * cr,
 
 
 
+void
+equinox_draw_menuitem (cairo_t * cr,
+		      const EquinoxColors * colors,
+		      const WidgetParameters * widget,
+		      int x, int y, int width, int height, int menuitemstyle)
+{
+	WidgetParameters from, to;
+	EquinoxCacheKey key;
+	cairo_surface_t *surface;
+	cairo_t *cache_cr;
+
+	/* GTK only draws the item while it is selected, so there is nothing to
+	 * fade out, and nothing to fade in from unless it was selected before */
+	if (EQX_STATE_CHANGING (widget) && equinox_transition_begin (cr, widget, &from, &to, x, y, width, height)) {
+		if (from.state_type == GTK_STATE_PRELIGHT)
+			equinox_draw_menuitem (cr, colors, &from, x, y, width, height, menuitemstyle);
+		equinox_transition_next (cr, widget);
+		equinox_draw_menuitem (cr, colors, &to, x, y, width, height, menuitemstyle);
+		equinox_transition_end (cr, widget);
+		return;
+	}
+
+	if (!equinox_cache_key_init (&key, EQX_CACHE_MENUITEM, colors, widget, width, height, menuitemstyle, 0, TRUE)) {
+		equinox_draw_menuitem_real (cr, colors, widget, x, y, width, height, menuitemstyle);
+		return;
+	}
+
+	surface = equinox_cache_lookup (&key);
+	if (surface == NULL) {
+		cache_cr = equinox_cache_begin_render (&key, &surface);
+		equinox_draw_menuitem_real (cache_cr, colors, widget, 0, 0, 2 * key.edge + 1, height, menuitemstyle);
+		cairo_destroy (cache_cr);
+		equinox_cache_insert (&key, surface);
+	}
+
+	equinox_cache_blit (cr, surface, key.edge, x, y, width, height);
+}
+
+
 void
 equinox_draw_scrollbar_trough (cairo_t * cr,
 			      const EquinoxColors * colors,
@@ -1882,6 +2286,7 @@ equinox_draw_scrollbar_trough (cairo_t * cr,
 	EquinoxRGB bg;
 	EquinoxRGB shadow, highlight;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	if (scrollbar->horizontal) {
 		int tmp = height;
@@ -1896,7 +2301,7 @@ equinox_draw_scrollbar_trough (cairo_t * cr,
 	if (scrollbartrough == 1) {
 		bg = colors->base[GTK_STATE_NORMAL];
 	} else {
-		bg = widget->parentbg;
+		bg = (*equinox_params_parentbg (widget));
 	}
 	if (scrollbarstyle == 4) {
 		equinox_rectangle (cr, EQX_CAIRO_FILL, 0, 0, width, height, &bg, 1.0);
@@ -1904,12 +2309,13 @@ equinox_draw_scrollbar_trough (cairo_t * cr,
 		equinox_shade (&bg, &shadow, 0.92);
 		equinox_shade (&bg, &highlight, 1.0);
 		equinox_shade (&bg, &bg, 0.98);
-		pattern = cairo_pattern_create_linear (0, 0, width, 0);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &shadow);
-		equinox_pattern_add_color_rgb (pattern, 0.22, &bg);
-		equinox_pattern_add_color_rgb (pattern, 0.55, &highlight);
-		equinox_pattern_add_color_rgb (pattern, 0.82, &bg);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &shadow);
+		equinox_gradient_init (&gradient, 0, 0, width, 0);
+		equinox_gradient_add_rgb (&gradient, 0.0, &shadow);
+		equinox_gradient_add_rgb (&gradient, 0.22, &bg);
+		equinox_gradient_add_rgb (&gradient, 0.55, &highlight);
+		equinox_gradient_add_rgb (&gradient, 0.82, &bg);
+		equinox_gradient_add_rgb (&gradient, 1.0, &shadow);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 	}
 }
@@ -1964,7 +2370,7 @@ void equinox_draw_scrollbar_stepper (cairo_t * cr, const EquinoxColors * colors,
 
 		//Shadow
 		EquinoxRGB shadow;
-		equinox_shade (&widget->parentbg, &shadow, 0.75);
+		equinox_shade (equinox_params_parentbg (widget), &shadow, 0.75);
 		if (first_curved)
 			equinox_draw_stepper_shadow(cr, 1.5, 2, width - 2, height, widget->curvature, widget->corners, &shadow);
 		if (second_curved)
@@ -2013,37 +2419,26 @@ void equinox_draw_scrollbar_stepper (cairo_t * cr, const EquinoxColors * colors,
 }
 
 
-void equinox_draw_scrollbar_slider (cairo_t * cr,
+/*
+  The slider is drawn in two passes: the body only varies across the slider
+  and can be served from the surface cache, the border and grips are laid
+  out along its length and are always drawn directly.  Both expect the
+  context to be set up so the slider runs horizontally from 0, 0.
+*/
+static void
+equinox_draw_scrollbar_slider_body (cairo_t * cr,
 			      const EquinoxColors * colors,
 			      const WidgetParameters * widget,
-			      const ScrollBarParameters * scrollbar,
-			      int x, int y, int width, int height, int scrollbarstyle, int scrollbarmargin) {
+			      int width, int height, int scrollbarstyle) {
 
 	EquinoxRGB bg;
 	EquinoxRGB bg_lighter, bg_mid, bg_darker;
-	EquinoxRGB border;
 
 	if (widget->prelight)
 		bg = colors->bg[GTK_STATE_PRELIGHT];
 	else
 		bg = colors->bg[GTK_STATE_ACTIVE];
 
-	equinox_shade (&bg, &border, 0.725);
-
-	//begin drawing
-	if (scrollbar->horizontal) {
-		/*y++;
-		height--;*/
-		cairo_translate (cr, x, y);
-	} else {
-		/*x++;
-		width--;*/
-		int tmp = height;
-		height = width;
-		width = tmp;
-		rotate_mirror_translate (cr, M_PI / 2, x, y, FALSE, FALSE);
-	}
-
 	int roundness = MIN (widget->curvature, height/2.0);
 	uint8 corners = EQX_CORNER_NONE;
 	// Use of scrollbarpadding parameter
@@ -2074,7 +2469,8 @@ void equinox_draw_scrollbar_slider (cairo_t * cr,
 		equinox_rounded_rectangle (cr, EQX_CAIRO_FILL, 0, 0, width , height, roundness, widget->corners, &shadow, 0.5);
 
 		cairo_pattern_t *pattern;
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
+		EquinoxGradient gradient;
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
 		if (scrollbarstyle == 1 || scrollbarstyle == 3) {
 			equinox_shade (&bg, &bg_darker, 0.85); // 0.76
 			equinox_shade (&bg, &bg_lighter, 1.24); // 1.24
@@ -2082,45 +2478,122 @@ void equinox_draw_scrollbar_slider (cairo_t * cr,
 			equinox_mix_color (&bg_darker, &bg_lighter, 0.9, &bg_lighter); // 0.80
 			equinox_mix_color (&bg_darker, &bg_lighter, 0.4, &bg_mid); // 0.55
 
-			equinox_pattern_add_color_rgb (pattern, 0.0, &bg_lighter);
-			equinox_pattern_add_color_rgb (pattern, 0.5, &bg_mid);
-			equinox_pattern_add_color_rgb (pattern, 0.5, &bg_darker);
-			equinox_pattern_add_color_rgb (pattern, 1.0, &bg);
+			equinox_gradient_add_rgb (&gradient, 0.0, &bg_lighter);
+			equinox_gradient_add_rgb (&gradient, 0.5, &bg_mid);
+			equinox_gradient_add_rgb (&gradient, 0.5, &bg_darker);
+			equinox_gradient_add_rgb (&gradient, 1.0, &bg);
 		} else {
 			equinox_shade_shift (&bg, &bg_lighter, 1.12);
 			equinox_shade_shift (&bg, &bg_darker, 0.92);
 
-			equinox_pattern_add_color_rgb (pattern, 0.0, &bg_lighter);
-			equinox_pattern_add_color_rgb (pattern, 0.5, &bg);
-			equinox_pattern_add_color_rgb (pattern, 1.0, &bg_darker);
+			equinox_gradient_add_rgb (&gradient, 0.0, &bg_lighter);
+			equinox_gradient_add_rgb (&gradient, 0.5, &bg);
+			equinox_gradient_add_rgb (&gradient, 1.0, &bg_darker);
 		}
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 1.5, 0.5, width - 3, height - 1, roundness, widget->corners, pattern);
 
 		// Draw highlight
 		EquinoxRGB highlight;
 		equinox_shade_shift (&bg, &highlight, 1.25);
 
-		pattern = cairo_pattern_create_linear (1, 1, 1 , height - 2);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, 0.75);
-		equinox_pattern_add_color_rgba (pattern, 0.9, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 1, 1, 1 , height - 2);
+		equinox_gradient_add_rgba (&gradient, 0.0, &highlight, 0.75);
+		equinox_gradient_add_rgba (&gradient, 0.9, &highlight, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 2.5, 1.5, width - 5, height - 3, roundness - 1, widget->corners, pattern);
+	}
+}
+
+static void
+equinox_draw_scrollbar_slider_border (cairo_t * cr,
+			      const EquinoxColors * colors,
+			      const WidgetParameters * widget,
+			      const ScrollBarParameters * scrollbar,
+			      int width, int height, int scrollbarstyle) {
 
-		// Draw border
-		EquinoxRGB border_lighter;
-		equinox_shade_shift (&border, &border, 0.68);
-		equinox_shade_shift (&border, &border_lighter, 1.30);
+	EquinoxRGB bg;
+	EquinoxRGB border;
+	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
-		pattern = cairo_pattern_create_linear (0, 0, width, 0);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &border_lighter);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &border);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &border_lighter);
-		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 1.5, 0.5, width - 3, height - 1, roundness, widget->corners, pattern);
-
-		//grips
-		if (scrollbarstyle >= 2) {
-			equinox_draw_inset_circle (cr, width / 2, height / 2, HANDLE_RADIUS, &bg, (scrollbar->horizontal) ? 0 : 1);
+	if (scrollbarstyle == 4)
+		return;
+
+	if (widget->prelight)
+		bg = colors->bg[GTK_STATE_PRELIGHT];
+	else
+		bg = colors->bg[GTK_STATE_ACTIVE];
+
+	equinox_shade (&bg, &border, 0.725);
+
+	int roundness = MIN (widget->curvature, height/2.0);
+
+	// Draw border
+	EquinoxRGB border_lighter;
+	equinox_shade_shift (&border, &border, 0.68);
+	equinox_shade_shift (&border, &border_lighter, 1.30);
+
+	equinox_gradient_init (&gradient, 0, 0, width, 0);
+	equinox_gradient_add_rgb (&gradient, 0.0, &border_lighter);
+	equinox_gradient_add_rgb (&gradient, 0.5, &border);
+	equinox_gradient_add_rgb (&gradient, 1.0, &border_lighter);
+	pattern = equinox_gradient_get_pattern (&gradient);
+	equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 1.5, 0.5, width - 3, height - 1, roundness, widget->corners, pattern);
+
+	//grips
+	if (scrollbarstyle >= 2) {
+		equinox_draw_inset_circle (cr, colors, width / 2, height / 2, HANDLE_RADIUS, &bg, (scrollbar->horizontal) ? 0 : 1);
+	}
+}
+
+void equinox_draw_scrollbar_slider (cairo_t * cr,
+			      const EquinoxColors * colors,
+			      const WidgetParameters * widget,
+			      const ScrollBarParameters * scrollbar,
+			      int x, int y, int width, int height, int scrollbarstyle, int scrollbarmargin) {
+
+	WidgetParameters from, to;
+	EquinoxCacheKey key;
+	cairo_surface_t *surface = NULL;
+	cairo_t *cache_cr;
+
+	if (EQX_STATE_CHANGING (widget) && equinox_transition_begin (cr, widget, &from, &to, x, y, width, height)) {
+		equinox_draw_scrollbar_slider (cr, colors, &from, scrollbar, x, y, width, height, scrollbarstyle, scrollbarmargin);
+		equinox_transition_next (cr, widget);
+		equinox_draw_scrollbar_slider (cr, colors, &to, scrollbar, x, y, width, height, scrollbarstyle, scrollbarmargin);
+		equinox_transition_end (cr, widget);
+		return;
+	}
+
+	//begin drawing
+	if (scrollbar->horizontal) {
+		/*y++;
+		height--;*/
+		cairo_translate (cr, x, y);
+	} else {
+		/*x++;
+		width--;*/
+		int tmp = height;
+		height = width;
+		width = tmp;
+		rotate_mirror_translate (cr, M_PI / 2, x, y, FALSE, FALSE);
+	}
+
+	if (equinox_cache_key_init (&key, EQX_CACHE_SCROLLBAR_SLIDER, colors, widget, width, height, scrollbarstyle, 0, FALSE)) {
+		surface = equinox_cache_lookup (&key);
+		if (surface == NULL) {
+			cache_cr = equinox_cache_begin_render (&key, &surface);
+			equinox_draw_scrollbar_slider_body (cache_cr, colors, widget, 2 * key.edge + 1, height, scrollbarstyle);
+			cairo_destroy (cache_cr);
+			equinox_cache_insert (&key, surface);
 		}
+		equinox_cache_blit (cr, surface, key.edge, 0, 0, width, height);
+	} else {
+		equinox_draw_scrollbar_slider_body (cr, colors, widget, width, height, scrollbarstyle);
 	}
+
+	equinox_draw_scrollbar_slider_border (cr, colors, widget, scrollbar, width, height, scrollbarstyle);
 }
 
 void
@@ -2144,9 +2617,9 @@ void equinox_draw_handle (cairo_t * cr,
 		    const HandleParameters * handle,
 		    int x, int y, int width, int height) {
 
-	//equinox_draw_inset_circle (cr, x + width / 2, y + height / 2 + (2 * HANDLE_RADIUS + 3), HANDLE_RADIUS, &widget->parentbg, 0);
-	equinox_draw_inset_circle (cr, x + width / 2, y + height / 2, HANDLE_RADIUS, &widget->parentbg, 0);
-	//equinox_draw_inset_circle (cr, x + width / 2, y + height / 2 - (2 * HANDLE_RADIUS + 3), HANDLE_RADIUS, &widget->parentbg, 0);
+	//equinox_draw_inset_circle (cr, x + width / 2, y + height / 2 + (2 * HANDLE_RADIUS + 3), HANDLE_RADIUS, equinox_params_parentbg (widget), 0);
+	equinox_draw_inset_circle (cr, colors, x + width / 2, y + height / 2, HANDLE_RADIUS, equinox_params_parentbg (widget), 0);
+	//equinox_draw_inset_circle (cr, x + width / 2, y + height / 2 - (2 * HANDLE_RADIUS + 3), HANDLE_RADIUS, equinox_params_parentbg (widget), 0);
 }
 
 
@@ -2180,9 +2653,11 @@ static void _equinox_draw_arrow (cairo_t * cr, EquinoxRGB * color,
 
 		equinox_shade (color, &bg_lighter, 1.15);
 		cairo_pattern_t *pattern;
-		pattern = cairo_pattern_create_linear (0, -height / 2, 0, height / 2);
-		equinox_pattern_add_color_rgba (pattern, 0.0, color, alpha);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &bg_lighter, alpha);
+		EquinoxGradient gradient;
+		equinox_gradient_init (&gradient, 0, -height / 2, 0, height / 2);
+		equinox_gradient_add_rgba (&gradient, 0.0, color, alpha);
+		equinox_gradient_add_rgba (&gradient, 1.0, &bg_lighter, alpha);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		cairo_set_source (cr, pattern);
 		cairo_fill (cr);
 	}
@@ -2197,20 +2672,40 @@ void equinox_draw_arrow (cairo_t * cr,
 
 	EquinoxRGB color;
 
+	EquinoxAtlasKey key;
+	EquinoxAtlasSprite sprite;
+	cairo_t *atlas_cr;
+
 	color = colors->text[widget->state_type];
 
 	if (color.r != colors->bg[GTK_STATE_NORMAL].r || color.g != colors->bg[GTK_STATE_NORMAL].g || color.b != colors->bg[GTK_STATE_NORMAL].b) {
 		gdouble tx, ty;
 
 		if (arrow->direction == EQX_DIRECTION_DOWN || arrow->direction == EQX_DIRECTION_UP) {
-			tx = (x + width / 2);
-			ty = (y + height / 2) + 0.5;
+			tx = 0;
+			ty = 0.5;
 		} else {
-			tx = (x + width / 2) + 0.5;
-			ty = (y + height / 2);
+			tx = 0.5;
+			ty = 0;
+		}
+
+		/* The arrow is always the same size; only its gradient follows
+		 * the height. */
+		if (!equinox_atlas_key_init (&key, EQX_ATLAS_ARROW, colors, widget->state_type, 0)) {
+			_equinox_draw_arrow (cr, &color, 1.0, arrow->direction, arrow->type, (x + width / 2) + tx, (y + height / 2) + ty, width, height);
+			return;
+		}
+
+		key.direction = arrow->direction;
+		key.size = height;
+
+		if (!equinox_atlas_lookup (&key, &sprite)) {
+			atlas_cr = equinox_atlas_begin_render (&key, &sprite);
+			_equinox_draw_arrow (atlas_cr, &color, 1.0, arrow->direction, arrow->type, sprite.x + tx, sprite.y + ty, width, height);
+			cairo_destroy (atlas_cr);
 		}
 
-		_equinox_draw_arrow (cr, &color, 1.0, arrow->direction, arrow->type, tx, ty, width, height);
+		equinox_atlas_blit (cr, &sprite, x + width / 2, y + height / 2);
 	}
 }
 
@@ -2223,20 +2718,22 @@ equinox_draw_resize_grip (cairo_t * cr,
 			 int x, int y, int width, int height, int resizegripstyle)
 {
 	if (resizegripstyle == 0) {
-		equinox_draw_inset_circle (cr, x + width / 2, y + height / 2, MAX(height/2 - 5, HANDLE_RADIUS), &colors->bg[GTK_STATE_NORMAL], 0);
+		equinox_draw_inset_circle (cr, colors, x + width / 2, y + height / 2, MAX(height/2 - 5, HANDLE_RADIUS), &colors->bg[GTK_STATE_NORMAL], 0);
 	} else {
 		int OFFSET = 2;
 		//cairo_translate (cr, 0.5, 0.5);
 		EquinoxRGB fill;
 		EquinoxRGB highlight;
 		cairo_pattern_t *pattern;
+		EquinoxGradient gradient;
 		cairo_move_to (cr, width - OFFSET, height - (RESIZE_GRIP_SIZE + OFFSET));
 		cairo_line_to (cr, width - OFFSET, height - OFFSET);
 		cairo_line_to (cr, width - (RESIZE_GRIP_SIZE + OFFSET), height - OFFSET);
-		equinox_shade (&widget->parentbg, &fill, 0.65);
-		pattern = cairo_pattern_create_linear (0, height - (RESIZE_GRIP_SIZE + OFFSET), 0, height - OFFSET);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &fill, 0.9);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &fill, 0.35);
+		equinox_shade (equinox_params_parentbg (widget), &fill, 0.65);
+		equinox_gradient_init (&gradient, 0, height - (RESIZE_GRIP_SIZE + OFFSET), 0, height - OFFSET);
+		equinox_gradient_add_rgba (&gradient, 0.0, &fill, 0.9);
+		equinox_gradient_add_rgba (&gradient, 1.0, &fill, 0.35);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		cairo_set_source (cr, pattern);
 		cairo_fill (cr);
 		// Highlight
@@ -2245,17 +2742,18 @@ equinox_draw_resize_grip (cairo_t * cr,
 		cairo_line_to (cr, width - (RESIZE_GRIP_SIZE + OFFSET + 0.5), height + 0.5 - OFFSET);
 		cairo_line_to (cr, width + 0.5 - OFFSET, height - (RESIZE_GRIP_SIZE + OFFSET + 0.5));
 		equinox_shade_shift (&colors->bg[GTK_STATE_NORMAL], &highlight, 1.15);
-		pattern = cairo_pattern_create_linear (0, height - (RESIZE_GRIP_SIZE + OFFSET), 0, height - OFFSET);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &highlight, 0.2);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.8);
+		equinox_gradient_init (&gradient, 0, height - (RESIZE_GRIP_SIZE + OFFSET), 0, height - OFFSET);
+		equinox_gradient_add_rgba (&gradient, 0.0, &highlight, 0.2);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.8);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		cairo_set_source (cr, pattern);
 		cairo_stroke (cr);
 	}
 
 }
 
-void
-equinox_draw_menu_checkbutton (cairo_t * cr,
+static void
+equinox_draw_menu_checkbutton_real (cairo_t * cr,
 			      const EquinoxColors * colors,
 			      const WidgetParameters * widget,
 			      const OptionParameters * status,
@@ -2286,7 +2784,7 @@ equinox_draw_menu_checkbutton (cairo_t * cr,
 	}
 }
 
-void equinox_draw_cell_checkbutton (cairo_t * cr,
+static void equinox_draw_cell_checkbutton_real (cairo_t * cr,
 			      const EquinoxColors * colors,
 			      const WidgetParameters * widget,
 			      const OptionParameters * status,
@@ -2344,7 +2842,7 @@ void equinox_draw_cell_checkbutton (cairo_t * cr,
 }
 
 
-void equinox_draw_checkbutton (cairo_t * cr,
+static void equinox_draw_checkbutton_real (cairo_t * cr,
 			 const EquinoxColors * colors,
 			 const WidgetParameters * widget,
 			 const OptionParameters * status,
@@ -2357,42 +2855,27 @@ void equinox_draw_checkbutton (cairo_t * cr,
 	EquinoxRGB shadow;
 	EquinoxRGB highlight;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	width = height = 15;
 
 	cairo_translate (cr, x, y);
 
-#ifdef HAVE_ANIMATION
-	EquinoxRGB bg_old, border_old;
-#endif
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 	//double border_scale = lightness < 0.5 ? (lightness*3.5) :1;
 	double border_scale = (widget->disabled ? 0.72 : 0.56) - 0.03 * 1 / lightness;
 	double highlight_scale = 0.19 - 0.025 * 1 / lightness;
 
 	if (status->draw_bullet) {
 		bg  = colors->base[GTK_STATE_SELECTED];
-#ifdef HAVE_ANIMATION
-		bg_old = colors->base[GTK_STATE_ACTIVE];
-		equinox_mix_color (&colors->shade[8], &bg, 0.18, &border_old);
-#endif
-		equinox_mix_color (&widget->parentbg, &colors->base[GTK_STATE_SELECTED], lightness < 0.6 ? 0.15 : 0.45, &border);
+		equinox_mix_color (equinox_params_parentbg (widget), &colors->base[GTK_STATE_SELECTED], lightness < 0.6 ? 0.15 : 0.45, &border);
 		equinox_shade (&border, &border, border_scale );
 	}
 	else {
 		bg = colors->base[widget->state_type];
-#ifdef HAVE_ANIMATION
-		bg_old  = colors->base[GTK_STATE_NORMAL];
-		equinox_shade (&colors->shade[8], &border_old, border_scale);
-#endif
-		equinox_shade (&widget->parentbg, &border, border_scale);
+		equinox_shade (equinox_params_parentbg (widget), &border, border_scale);
 	}
 
-#ifdef HAVE_ANIMATION
-	equinox_mix_color (&bg_old, &bg, widget->trans, &bg);
-	equinox_mix_color (&border_old, &border, widget->trans, &border);
-#endif
-
 	if (widget->prelight) {
 		equinox_shade_shift (&bg, &bg, 1.09);
 		equinox_shade_shift (&bg, &highlight, 1.2);
@@ -2415,27 +2898,29 @@ void equinox_draw_checkbutton (cairo_t * cr,
 		if (checkradiostyle == 1) {
 			equinox_shade_shift (&bg, &bg_darker, widget->disabled? 0.92 : 0.90);
 			equinox_mix_color (&bg, &highlight, 0.50, &mid_highlight);
-			pattern = cairo_pattern_create_linear (3, 3, 3, height-4);
-			equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-			equinox_pattern_add_color_rgb (pattern, 0.5, &mid_highlight);
-			equinox_pattern_add_color_rgb (pattern, 0.5, &bg);
-			equinox_pattern_add_color_rgb (pattern, 1.0, &bg_darker);
+			equinox_gradient_init (&gradient, 3, 3, 3, height-4);
+			equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+			equinox_gradient_add_rgb (&gradient, 0.5, &mid_highlight);
+			equinox_gradient_add_rgb (&gradient, 0.5, &bg);
+			equinox_gradient_add_rgb (&gradient, 1.0, &bg_darker);
 		} else {
 			equinox_shade_shift (&bg, &highlight, 1.15);
 			equinox_shade_shift (&bg, &bg_darker, widget->disabled? 0.92 : 0.82);
-			pattern = cairo_pattern_create_linear (2, 2, 2, height-4);
-			equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-			equinox_pattern_add_color_rgb (pattern, 0.55, &bg);
-			equinox_pattern_add_color_rgb (pattern, 1.0, &bg_darker);
+			equinox_gradient_init (&gradient, 2, 2, 2, height-4);
+			equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+			equinox_gradient_add_rgb (&gradient, 0.55, &bg);
+			equinox_gradient_add_rgb (&gradient, 1.0, &bg_darker);
 		}
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_FILL, 2.0, 2.0, width - 4, height - 4, ROUNDNESS-0.5, widget->corners, pattern);
 
 		// Stroke highlight
 		equinox_shade_shift (&highlight, &highlight, widget->disabled ? 1.05 : 1.08);
 
-		pattern = cairo_pattern_create_linear (0, 2.5, 0, height-2);
-		equinox_pattern_add_color_rgb  (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 0, 2.5, 0, height-2);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rounded_gradient (cr, EQX_CAIRO_STROKE, 2.5, 2.5, width - 5, height - 5, ROUNDNESS-0.5, widget->corners, pattern);
 
 		// Inner glow
@@ -2471,11 +2956,14 @@ void equinox_draw_checkbutton (cairo_t * cr,
 		equinox_draw_border (cr, 1.5, 1.5, width - 3, height - 3, ROUNDNESS, widget->corners, &border, 1.18, 0.85);
 	} else {
 		// Draw the shadow inset for unchecked shadow for checked
-		equinox_draw_etched_shadow (cr, 0.5, 0.5, width - 1, height - 1.5, ROUNDNESS + 1, widget->corners, &widget->parentbg, 1.0);
+		equinox_draw_etched_shadow (cr, 0.5, 0.5, width - 1, height - 1.5, ROUNDNESS + 1, widget->corners, equinox_params_parentbg (widget), 1.0);
 		// Border
 		equinox_draw_etched_border (cr, 1.5, 1.5, width - 3, height - 3, ROUNDNESS, widget->corners, &border, 1.25, 0.85);
 	}
 
+	/* unchecked boxes have no mark */
+	if (!status->draw_bullet)
+		return;
 
 	cairo_save(cr);
 	if (!widget->disabled) {
@@ -2494,10 +2982,7 @@ void equinox_draw_checkbutton (cairo_t * cr,
 			  cairo_close_path (cr);
 		}
     }
-	if (status->draw_bullet)
-		equinox_set_source_rgba (cr, &shadow, 0.55 * widget->trans);
-	else
-		equinox_set_source_rgba (cr, &shadow, 0.55 * (1 - widget->trans));
+	equinox_set_source_rgba (cr, &shadow, 0.55);
 	cairo_set_line_width(cr, 0.50);
 	cairo_stroke (cr);
 	cairo_restore(cr);
@@ -2515,16 +3000,13 @@ void equinox_draw_checkbutton (cairo_t * cr,
 		cairo_rel_line_to (cr, -6.95, 12.5);
 		cairo_close_path (cr);
 	}
-	if (status->draw_bullet)
-    	equinox_set_source_rgba (cr, &bullet, widget->trans);
-    else
-     	equinox_set_source_rgba (cr, &bullet, (1 - widget->trans));
+	equinox_set_source_rgb (cr, &bullet);
 	cairo_fill (cr);
 
 }
 
-void
-equinox_draw_menu_radiobutton (cairo_t * cr,
+static void
+equinox_draw_menu_radiobutton_real (cairo_t * cr,
 			      const EquinoxColors * colors,
 			      const WidgetParameters * widget,
 			      const OptionParameters * status,
@@ -2560,8 +3042,8 @@ equinox_draw_menu_radiobutton (cairo_t * cr,
   }
 }
 
-void
-equinox_draw_cell_radiobutton (cairo_t * cr,
+static void
+equinox_draw_cell_radiobutton_real (cairo_t * cr,
 			      const EquinoxColors * colors,
 			      const WidgetParameters * widget,
 			      const OptionParameters * status,
@@ -2628,7 +3110,7 @@ equinox_draw_cell_radiobutton (cairo_t * cr,
 
 
 
-void equinox_draw_radiobutton (cairo_t * cr,
+static void equinox_draw_radiobutton_real (cairo_t * cr,
 			 const EquinoxColors * colors,
 			 const WidgetParameters * widget,
 			 const OptionParameters * status,
@@ -2640,42 +3122,27 @@ void equinox_draw_radiobutton (cairo_t * cr,
 	EquinoxRGB shadow;
 	EquinoxRGB highlight;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	width = height = 15;
 	double center = width / 2.0 - 1.5;
 
 	cairo_translate (cr, x, y);
 
-#ifdef HAVE_ANIMATION
-	EquinoxRGB bg_old, border_old;
-#endif
-	double lightness = equinox_get_lightness(&widget->parentbg);
+	double lightness = equinox_get_lightness(equinox_params_parentbg (widget));
 	//double border_scale = lightness < 0.5 ? 0.72 : 0.56;
 	double border_scale = (widget->disabled ? 0.72 : 0.56) - 0.03 * 1 / lightness;
 	double highlight_scale = 0.19 - 0.025 * 1 / lightness;
 
 	if (status->draw_bullet) {
 		bg  = colors->base[GTK_STATE_SELECTED];
-#ifdef HAVE_ANIMATION
-		bg_old = colors->base[GTK_STATE_ACTIVE];
-		equinox_mix_color (&colors->shade[8], &bg, 0.18, &border_old);
-#endif
-		equinox_mix_color (&widget->parentbg, &colors->base[GTK_STATE_SELECTED], lightness < 0.6 ? 0.15 : 0.45, &border);
+		equinox_mix_color (equinox_params_parentbg (widget), &colors->base[GTK_STATE_SELECTED], lightness < 0.6 ? 0.15 : 0.45, &border);
 		equinox_shade (&border, &border, 0.56);
 	} else {
 		bg = colors->base[widget->state_type];
-#ifdef HAVE_ANIMATION
-		bg_old  = colors->base[GTK_STATE_NORMAL];
-		equinox_shade (&colors->shade[8], &border_old, border_scale);
-#endif
-		equinox_shade (&widget->parentbg, &border, border_scale);
+		equinox_shade (equinox_params_parentbg (widget), &border, border_scale);
 	}
 
-#ifdef HAVE_ANIMATION
-	equinox_mix_color (&bg_old, &bg, widget->trans, &bg);
-	equinox_mix_color (&border_old, &border, widget->trans, &border);
-#endif
-
 	if (widget->prelight) {
 		equinox_shade_shift (&bg, &bg, 1.09);
 		equinox_shade_shift (&bg, &highlight, 1.2);
@@ -2696,27 +3163,29 @@ void equinox_draw_radiobutton (cairo_t * cr,
 		if (checkradiostyle == 1) {
 			equinox_shade_shift (&bg, &bg_darker, widget->disabled? 0.92 : 0.90);
 			equinox_mix_color (&bg, &highlight, 0.60, &mid_highlight);
-			pattern = cairo_pattern_create_linear (3, 3, 3, height-4);
-			equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-			equinox_pattern_add_color_rgb (pattern, 0.5, &mid_highlight);
-			equinox_pattern_add_color_rgb (pattern, 0.5, &bg);
-			equinox_pattern_add_color_rgb (pattern, 1.0, &bg_darker);
+			equinox_gradient_init (&gradient, 3, 3, 3, height-4);
+			equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+			equinox_gradient_add_rgb (&gradient, 0.5, &mid_highlight);
+			equinox_gradient_add_rgb (&gradient, 0.5, &bg);
+			equinox_gradient_add_rgb (&gradient, 1.0, &bg_darker);
 		} else {
 			equinox_shade_shift (&bg, &highlight, 1.15);
 			equinox_shade_shift (&bg, &bg_darker, widget->disabled? 0.90 : 0.86);
-			pattern = cairo_pattern_create_linear (2, 2, 2, height-4);
-			equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-			equinox_pattern_add_color_rgb (pattern, 0.55, &bg);
-			equinox_pattern_add_color_rgb (pattern, 1.0, &bg_darker);
+			equinox_gradient_init (&gradient, 2, 2, 2, height-4);
+			equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+			equinox_gradient_add_rgb (&gradient, 0.55, &bg);
+			equinox_gradient_add_rgb (&gradient, 1.0, &bg_darker);
 		}
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_FILL, center + 1.5, center + 1.5, center -0.5, 0, M_PI * 2, pattern);
 
 		// Stroke highlight
 		equinox_shade_shift (&highlight, &highlight, widget->disabled ? 1.06 : 1.08);
 
-		pattern = cairo_pattern_create_linear (0, 2, 0, height-2);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &highlight);
-		equinox_pattern_add_color_rgba (pattern, 0.8, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 0, 2, 0, height-2);
+		equinox_gradient_add_rgb (&gradient, 0.0, &highlight);
+		equinox_gradient_add_rgba (&gradient, 0.8, &highlight, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_STROKE, center + 1.5, center + 1.5, center - 1, 0, M_PI * 2, pattern);
 
 		// Inner glow
@@ -2733,32 +3202,35 @@ void equinox_draw_radiobutton (cairo_t * cr,
 		equinox_arc (cr, EQX_CAIRO_FILL, center + 1.5, center + 1.5, center -0.5, 0, M_PI * 2, &bg, 1.0);
 
 		// Inner shadow
-		pattern = cairo_pattern_create_linear (0, 2, 0, height-2);
-		equinox_pattern_add_color_rgba (pattern, 0.3, &shadow, 0.32);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 0, 2, 0, height-2);
+		equinox_gradient_add_rgba (&gradient, 0.3, &shadow, 0.32);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_STROKE, center + 1.5, center + 1.5, center - 1, M_PI * 0.75, M_PI * 0.25, pattern);
-		pattern = cairo_pattern_create_linear (0, 2, 0, height-4);
-		equinox_pattern_add_color_rgba (pattern, 0.3, &shadow, 0.06);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight, 0.0);
+		equinox_gradient_init (&gradient, 0, 2, 0, height-4);
+		equinox_gradient_add_rgba (&gradient, 0.3, &shadow, 0.06);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight, 0.0);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_STROKE, center + 1.5, center + 1.5, center - 2, M_PI * 0.75, M_PI * 0.25, pattern);
 	}
 
 	//Border
 	EquinoxRGB border_darker, border_lighter;
-	pattern = cairo_pattern_create_linear (0, 2, 0, height-2);
+	equinox_gradient_init (&gradient, 0, 2, 0, height-2);
 	if (status->draw_bullet) {
 		equinox_shade_shift (&border, &border_darker, 0.85);
 		equinox_shade_shift (&border, &border_lighter, widget->disabled ? 1.20 : 1.35);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &border_lighter);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &border);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &border_darker);
+		equinox_gradient_add_rgb (&gradient, 0.0, &border_lighter);
+		equinox_gradient_add_rgb (&gradient, 0.5, &border);
+		equinox_gradient_add_rgb (&gradient, 1.0, &border_darker);
 	} else {
 		equinox_shade_shift (&border, &border_darker, 0.78);
 		equinox_shade_shift (&border, &border_lighter, 1.35);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &border_darker);
-		equinox_pattern_add_color_rgb (pattern, 0.5, &border);
-		equinox_pattern_add_color_rgb (pattern, 1.0, &border_lighter);
+		equinox_gradient_add_rgb (&gradient, 0.0, &border_darker);
+		equinox_gradient_add_rgb (&gradient, 0.5, &border);
+		equinox_gradient_add_rgb (&gradient, 1.0, &border_lighter);
 	}
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_arc_gradient (cr, EQX_CAIRO_STROKE, center + 1.5, center + 1.5, center , 0, M_PI * 2, pattern);
 
    	// Draw the shadow : inset for unchecked shadow for checked
@@ -2769,17 +3241,21 @@ void equinox_draw_radiobutton (cairo_t * cr,
 		EquinoxRGB shadow1;
 		EquinoxRGB highlight1;
 
-		equinox_shade_shift (&widget->parentbg, &shadow1, 0.8);
-		equinox_shade_shift (&widget->parentbg, &highlight1, 1.26);
+		equinox_shade_shift (equinox_params_parentbg (widget), &shadow1, 0.8);
+		equinox_shade_shift (equinox_params_parentbg (widget), &highlight1, 1.26);
 
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgba (pattern, 0.0, &shadow1, 0.40);
-		equinox_pattern_add_color_rgba (pattern, 0.5, &widget->parentbg, 0.0);
-		equinox_pattern_add_color_rgba (pattern, 1.0, &highlight1, 0.40);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgba (&gradient, 0.0, &shadow1, 0.40);
+		equinox_gradient_add_rgba (&gradient, 0.5, equinox_params_parentbg (widget), 0.0);
+		equinox_gradient_add_rgba (&gradient, 1.0, &highlight1, 0.40);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_arc_gradient (cr, EQX_CAIRO_STROKE, center + 1.5, center + 1.5, center + 1, 0, M_PI * 2, pattern);
 	}
 
 	// Bullet
+	if (!status->draw_bullet)
+		return;
+
 	cairo_save (cr);
 	if (!widget->disabled) {
 		cairo_translate (cr, 0.0, 0.2);
@@ -2788,10 +3264,7 @@ void equinox_draw_radiobutton (cairo_t * cr,
 		else
 			cairo_arc (cr, center + 1.5, center + 1.5, center - 3.25, 0, M_PI * 2);
 	}
-	if (status->draw_bullet)
-		equinox_set_source_rgba (cr, &shadow, 0.55 * widget->trans);
-	else
-		equinox_set_source_rgba (cr, &shadow, 0.55 * (1 - widget->trans));
+	equinox_set_source_rgba (cr, &shadow, 0.55);
 	cairo_set_line_width(cr, 0.50);
 	cairo_stroke (cr);
 	cairo_restore (cr);
@@ -2800,15 +3273,150 @@ void equinox_draw_radiobutton (cairo_t * cr,
 		clearlooks_rounded_rectangle(cr, 4, 6, 7, 3, 1.5, EQX_CORNER_ALL);
 	else
 		cairo_arc (cr, center + 1.5, center + 1.5, center - 3.25, 0, M_PI * 2);
-	if (status->draw_bullet)
-		equinox_set_source_rgba (cr, &bullet, widget->trans);
-	else
-		equinox_set_source_rgba (cr, &bullet, (1 - widget->trans));
+	equinox_set_source_rgb (cr, &bullet);
 	cairo_fill (cr);
 }
 
+static void
+equinox_draw_option_glyph (cairo_t * cr, EquinoxAtlasGlyph glyph,
+			  const EquinoxColors * colors,
+			  const WidgetParameters * widget,
+			  const OptionParameters * status,
+			  int x, int y, int width, int height, int checkradiostyle)
+{
+	switch (glyph) {
+		case EQX_ATLAS_CHECK:
+			equinox_draw_checkbutton_real (cr, colors, widget, status, x, y, width, height, checkradiostyle);
+			break;
+		case EQX_ATLAS_RADIO:
+			equinox_draw_radiobutton_real (cr, colors, widget, status, x, y, width, height, checkradiostyle);
+			break;
+		case EQX_ATLAS_MENU_CHECK:
+			equinox_draw_menu_checkbutton_real (cr, colors, widget, status, x, y, width, height);
+			break;
+		case EQX_ATLAS_MENU_RADIO:
+			equinox_draw_menu_radiobutton_real (cr, colors, widget, status, x, y, width, height);
+			break;
+		case EQX_ATLAS_CELL_CHECK:
+			equinox_draw_cell_checkbutton_real (cr, colors, widget, status, x, y, width, height);
+			break;
+		case EQX_ATLAS_CELL_RADIO:
+			equinox_draw_cell_radiobutton_real (cr, colors, widget, status, x, y, width, height);
+			break;
+		default:
+			g_assert_not_reached ();
+	}
+}
+
+/* All the check and radio indicators are drawn at a fixed size, so they are
+ * taken from the indicator atlas.  Only the regular ones depend on the
+ * parent background. */
+static void
+equinox_draw_option (cairo_t * cr, EquinoxAtlasGlyph glyph,
+		    const EquinoxColors * colors,
+		    const WidgetParameters * widget,
+		    const OptionParameters * status,
+		    int x, int y, int width, int height, int checkradiostyle)
+{
+	gboolean themed = (glyph == EQX_ATLAS_CHECK || glyph == EQX_ATLAS_RADIO);
+	WidgetParameters from, to;
+	OptionParameters toggled;
+	EquinoxAtlasKey key;
+	EquinoxAtlasSprite sprite;
+	cairo_t *atlas_cr;
+
+	/* a toggle fades between the unchecked and the checked sprite */
+	if (equinox_transition_begin (cr, widget, &from, &to, x - EQX_ATLAS_PAD, y - EQX_ATLAS_PAD, EQX_ATLAS_CELL, EQX_ATLAS_CELL)) {
+		toggled = *status;
+		toggled.draw_bullet = !status->draw_bullet;
+		equinox_draw_option (cr, glyph, colors, &from, &toggled, x, y, width, height, checkradiostyle);
+		equinox_transition_next (cr, widget);
+		equinox_draw_option (cr, glyph, colors, &to, status, x, y, width, height, checkradiostyle);
+		equinox_transition_end (cr, widget);
+		return;
+	}
+
+	if (!equinox_atlas_key_init (&key, glyph, colors, widget->state_type, themed ? checkradiostyle : 0)) {
+		equinox_draw_option_glyph (cr, glyph, colors, widget, status, x, y, width, height, checkradiostyle);
+		return;
+	}
+
+	key.flags = (widget->prelight ? 1 : 0) |
+	            (widget->disabled ? 2 : 0) |
+	            (status->draw_bullet ? 4 : 0) |
+	            (status->inconsistent ? 8 : 0);
+	key.corners = widget->corners;
+	if (themed)
+		key.color = *equinox_params_parentbg (widget);
 
+	if (!equinox_atlas_lookup (&key, &sprite)) {
+		atlas_cr = equinox_atlas_begin_render (&key, &sprite);
+		equinox_draw_option_glyph (atlas_cr, glyph, colors, widget, status, sprite.x, sprite.y, width, height, checkradiostyle);
+		cairo_destroy (atlas_cr);
+	}
+
+	equinox_atlas_blit (cr, &sprite, x, y);
+}
 
+void
+equinox_draw_checkbutton (cairo_t * cr,
+			 const EquinoxColors * colors,
+			 const WidgetParameters * widget,
+			 const OptionParameters * status,
+			 int x, int y, int width, int height, int checkradiostyle)
+{
+	equinox_draw_option (cr, EQX_ATLAS_CHECK, colors, widget, status, x, y, width, height, checkradiostyle);
+}
+
+void
+equinox_draw_radiobutton (cairo_t * cr,
+			 const EquinoxColors * colors,
+			 const WidgetParameters * widget,
+			 const OptionParameters * status,
+			 int x, int y, int width, int height, int checkradiostyle)
+{
+	equinox_draw_option (cr, EQX_ATLAS_RADIO, colors, widget, status, x, y, width, height, checkradiostyle);
+}
+
+void
+equinox_draw_menu_checkbutton (cairo_t * cr,
+			      const EquinoxColors * colors,
+			      const WidgetParameters * widget,
+			      const OptionParameters * status,
+			      int x, int y, int width, int height)
+{
+	equinox_draw_option (cr, EQX_ATLAS_MENU_CHECK, colors, widget, status, x, y, width, height, 0);
+}
+
+void
+equinox_draw_menu_radiobutton (cairo_t * cr,
+			      const EquinoxColors * colors,
+			      const WidgetParameters * widget,
+			      const OptionParameters * status,
+			      int x, int y, int width, int height)
+{
+	equinox_draw_option (cr, EQX_ATLAS_MENU_RADIO, colors, widget, status, x, y, width, height, 0);
+}
+
+void
+equinox_draw_cell_checkbutton (cairo_t * cr,
+			      const EquinoxColors * colors,
+			      const WidgetParameters * widget,
+			      const OptionParameters * status,
+			      int x, int y, int width, int height)
+{
+	equinox_draw_option (cr, EQX_ATLAS_CELL_CHECK, colors, widget, status, x, y, width, height, 0);
+}
+
+void
+equinox_draw_cell_radiobutton (cairo_t * cr,
+			      const EquinoxColors * colors,
+			      const WidgetParameters * widget,
+			      const OptionParameters * status,
+			      int x, int y, int width, int height)
+{
+	equinox_draw_option (cr, EQX_ATLAS_CELL_RADIO, colors, widget, status, x, y, width, height, 0);
+}
 
 void
 equinox_draw_tooltip (cairo_t * cr,
@@ -2820,6 +3428,7 @@ equinox_draw_tooltip (cairo_t * cr,
 	const EquinoxRGB *highlight = &colors->text[GTK_STATE_SELECTED];
 	EquinoxRGB darker;
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	cairo_translate (cr, x, y);
 
@@ -2828,9 +3437,10 @@ equinox_draw_tooltip (cairo_t * cr,
 
 	equinox_shade_shift (&colors->bg[GTK_STATE_NORMAL], &darker, 0.90);
 
-	pattern = cairo_pattern_create_linear (0, 0, width*0.75, height);
-	cairo_pattern_add_color_stop_rgb (pattern, 0.0, colors->bg[GTK_STATE_NORMAL].r, colors->bg[GTK_STATE_NORMAL].g, colors->bg[GTK_STATE_NORMAL].b);
-	cairo_pattern_add_color_stop_rgb (pattern, 1.0, darker.r, darker.g, darker.b);
+	equinox_gradient_init (&gradient, 0, 0, width*0.75, height);
+	equinox_gradient_add_rgb (&gradient, 0.0, &colors->bg[GTK_STATE_NORMAL]);
+	equinox_gradient_add_rgb (&gradient, 1.0, &darker);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	cairo_set_source (cr, pattern);
 	cairo_pattern_destroy (pattern);
 
@@ -2867,6 +3477,7 @@ void equinox_draw_list_selection (cairo_t * cr,
 	EquinoxRGB border;
 
 	cairo_pattern_t *pattern;
+	EquinoxGradient gradient;
 
 	if (widget->focus)
 		fill_color = colors->base[widget->state_type];
@@ -2880,9 +3491,10 @@ void equinox_draw_list_selection (cairo_t * cr,
 
 	cairo_translate (cr, x, y);
 
-	pattern = cairo_pattern_create_linear (0, 0, 0, height);
-	equinox_pattern_add_color_rgb (pattern, 0.0, &fill_light);
-	equinox_pattern_add_color_rgb (pattern, 1.0, &fill_shade);
+	equinox_gradient_init (&gradient, 0, 0, 0, height);
+	equinox_gradient_add_rgb (&gradient, 0.0, &fill_light);
+	equinox_gradient_add_rgb (&gradient, 1.0, &fill_shade);
+	pattern = equinox_gradient_get_pattern (&gradient);
 	equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 
 	// Highlight
@@ -2911,15 +3523,17 @@ void equinox_draw_list_item (cairo_t * cr,
 
 	if (listviewitemstyle == 1) {
 		cairo_pattern_t *pattern;
+		EquinoxGradient gradient;
 
 		equinox_shade_shift (&fill, &fill_shade, 0.92);
 		equinox_mix_color (&fill_shade, &fill, 0.78, &fill_middle);
 		cairo_translate (cr, x, y);
 
-		pattern = cairo_pattern_create_linear (0, 0, 0, height);
-		equinox_pattern_add_color_rgb (pattern, 0.0, &fill_shade);
-		equinox_pattern_add_color_rgb (pattern, 0.15 * 20 / height, &fill_middle);
-		equinox_pattern_add_color_rgb (pattern, 0.3 * 20 / height, &fill);
+		equinox_gradient_init (&gradient, 0, 0, 0, height);
+		equinox_gradient_add_rgb (&gradient, 0.0, &fill_shade);
+		equinox_gradient_add_rgb (&gradient, 0.15 * 20 / height, &fill_middle);
+		equinox_gradient_add_rgb (&gradient, 0.3 * 20 / height, &fill);
+		pattern = equinox_gradient_get_pattern (&gradient);
 		equinox_rectangle_gradient (cr, EQX_CAIRO_FILL, 0, 0, width, height, pattern);
 
 	}
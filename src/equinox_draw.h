@@ -8,6 +8,8 @@
 
 #include <cairo.h>
 
+G_GNUC_INTERNAL void equinox_derive_colors         (EquinoxColors *colors, int buttonstyle);
+
 G_GNUC_INTERNAL void equinox_draw_button           (cairo_t *cr,
                                        const EquinoxColors      *colors,
                                        const WidgetParameters      *widget,
@@ -30,7 +32,7 @@ G_GNUC_INTERNAL void equinox_draw_progressbar_fill (cairo_t *cr,
                                        const EquinoxColors      *colors,
                                        const WidgetParameters      *widget,
                                        const ProgressBarParameters *progressbar,
-                                       int x, int y, int width, int height, gint offset, int progressbarstyle);
+                                       int x, int y, int width, int height, gdouble phase, int progressbarstyle);
 
 G_GNUC_INTERNAL void equinox_draw_scale_slider    (cairo_t *cr,
                                        const EquinoxColors     *colors,
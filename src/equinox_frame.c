@@ -0,0 +1,288 @@
+/* Equinox Engine
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Frame memo
+ *
+ * One expose of a window ends up in the style many times: box, shadow,
+ * focus, layout and arrows of the same widget and its neighbours.  Within
+ * that paint cycle the window gets a single cairo context, handed out
+ * inside cairo_save/cairo_restore, and the widget parameters resolved for
+ * a (widget, style, state) are reused by the following calls.
+ *
+ * GTK has no expose serial, so a frame is identified by the window and by
+ * what GDK is currently painting it into (the double buffer pixmap and its
+ * offset).  A new paint of the same window therefore starts a new frame.
+ * The frames are dropped by a high priority idle that runs as soon as the
+ * current main loop dispatch, and with it the expose, has finished.
+ */
+
+#include "equinox_frame.h"
+
+typedef struct {
+	const GtkWidget *widget;
+	const GtkStyle *style;
+	GtkStateType state_type;
+} EquinoxFrameParamsKey;
+
+typedef struct {
+	GdkWindow *window;
+	GdkDrawable *target;	/* what the window is being painted into */
+	gint x_offset, y_offset;
+	cairo_t *cr;		/* created on first use */
+	guint depth;		/* cairo_save levels handed out */
+	GHashTable *params;	/* EquinoxFrameParamsKey -> WidgetParameters */
+} EquinoxFrame;
+
+/* GdkWindow -> EquinoxFrame */
+static GHashTable *frames = NULL;
+static guint teardown_id = 0;
+static EquinoxFrameStats frame_stats;
+
+static const cairo_user_data_key_t frame_key;
+
+static guint
+params_key_hash (gconstpointer key)
+{
+	const EquinoxFrameParamsKey *k = key;
+
+	return GPOINTER_TO_UINT (k->widget) ^ (GPOINTER_TO_UINT (k->style) >> 4) ^ k->state_type;
+}
+
+static gboolean
+params_key_equal (gconstpointer a, gconstpointer b)
+{
+	const EquinoxFrameParamsKey *ka = a;
+	const EquinoxFrameParamsKey *kb = b;
+
+	return ka->widget == kb->widget && ka->style == kb->style && ka->state_type == kb->state_type;
+}
+
+static void
+params_free (gpointer params)
+{
+	g_slice_free (WidgetParameters, params);
+}
+
+static void
+params_key_free (gpointer key)
+{
+	g_slice_free (EquinoxFrameParamsKey, key);
+}
+
+static void
+frame_free (gpointer data)
+{
+	EquinoxFrame *frame = data;
+
+	if (frame->cr)
+		cairo_destroy (frame->cr);
+	if (frame->params)
+		g_hash_table_destroy (frame->params);
+	g_object_unref (frame->target);
+	g_object_unref (frame->window);
+	g_slice_free (EquinoxFrame, frame);
+}
+
+static gboolean
+frame_teardown (gpointer data)
+{
+	teardown_id = 0;
+	if (frames)
+		g_hash_table_remove_all (frames);
+
+	return FALSE;
+}
+
+static EquinoxFrame *
+frame_get (GdkDrawable *window)
+{
+	EquinoxFrame *frame = NULL;
+	GdkDrawable *target;
+	gint x_offset, y_offset;
+
+	if (!window || !GDK_IS_WINDOW (window))
+		return NULL;
+
+	gdk_window_get_internal_paint_info (window, &target, &x_offset, &y_offset);
+
+	if (frames)
+		frame = g_hash_table_lookup (frames, window);
+
+	if (frame) {
+		if (frame->target == target && frame->x_offset == x_offset && frame->y_offset == y_offset)
+			return frame;
+
+		/* painted again; the old context is still in use further up */
+		if (frame->depth > 0)
+			return NULL;
+	}
+
+	if (frames == NULL)
+		frames = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, frame_free);
+
+	frame = g_slice_new0 (EquinoxFrame);
+	frame->window = g_object_ref (window);
+	frame->target = g_object_ref (target);
+	frame->x_offset = x_offset;
+	frame->y_offset = y_offset;
+	g_hash_table_replace (frames, window, frame);
+	frame_stats.frames++;
+
+	if (teardown_id == 0)
+		teardown_id = g_idle_add_full (G_PRIORITY_HIGH, frame_teardown, NULL, NULL);
+
+	return frame;
+}
+
+cairo_t *
+equinox_frame_begin_paint (GdkDrawable *window, EquinoxFrameSetupFunc setup)
+{
+	EquinoxFrame *frame = frame_get (window);
+
+	if (frame == NULL) {
+		frame_stats.unpooled++;
+		return NULL;
+	}
+
+	if (frame->cr && frame->depth == 0 && cairo_status (frame->cr) != CAIRO_STATUS_SUCCESS) {
+		cairo_destroy (frame->cr);
+		frame->cr = NULL;
+	}
+
+	if (frame->cr == NULL) {
+		frame->cr = gdk_cairo_create (window);
+		cairo_set_user_data (frame->cr, &frame_key, frame, NULL);
+		/* becomes the base state every call starts from */
+		if (setup)
+			setup (frame->cr);
+		frame_stats.contexts++;
+	} else {
+		frame_stats.context_reuses++;
+	}
+
+	cairo_save (frame->cr);
+	frame->depth++;
+
+	return frame->cr;
+}
+
+gboolean
+equinox_frame_end_paint (cairo_t *cr)
+{
+	EquinoxFrame *frame = cairo_get_user_data (cr, &frame_key);
+
+	if (frame == NULL)
+		return FALSE;
+
+	/* the path is not part of the saved state */
+	cairo_new_path (cr);
+	cairo_restore (cr);
+	frame->depth--;
+
+	/* GDK may draw into the window itself before the next call */
+	cairo_surface_flush (cairo_get_target (cr));
+
+	return TRUE;
+}
+
+WidgetParameters *
+equinox_frame_lookup_params (GdkDrawable *window, const GtkWidget *widget,
+                             const GtkStyle *style, GtkStateType state_type)
+{
+	EquinoxFrameParamsKey key;
+	EquinoxFrame *frame;
+	WidgetParameters *params;
+
+	if (widget == NULL || frames == NULL)
+		return NULL;
+
+	frame = frame_get (window);
+	if (frame == NULL || frame->params == NULL)
+		return NULL;
+
+	key.widget = widget;
+	key.style = style;
+	key.state_type = state_type;
+
+	params = g_hash_table_lookup (frame->params, &key);
+	if (params)
+		frame_stats.params_hits++;
+
+	return params;
+}
+
+WidgetParameters *
+equinox_frame_insert_params (GdkDrawable *window, const GtkWidget *widget,
+                             const GtkStyle *style, GtkStateType state_type,
+                             const WidgetParameters *params)
+{
+	EquinoxFrameParamsKey *key;
+	EquinoxFrame *frame;
+	WidgetParameters *copy;
+
+	if (widget == NULL)
+		return NULL;
+
+	frame = frame_get (window);
+	if (frame == NULL)
+		return NULL;
+
+	if (frame->params == NULL)
+		frame->params = g_hash_table_new_full (params_key_hash, params_key_equal, params_key_free, params_free);
+
+	key = g_slice_new (EquinoxFrameParamsKey);
+	key->widget = widget;
+	key->style = style;
+	key->state_type = state_type;
+
+	copy = g_slice_new (WidgetParameters);
+	*copy = *params;
+	copy->lazy = &copy->own_lazy;
+	g_hash_table_replace (frame->params, key, copy);
+	frame_stats.params_misses++;
+
+	return copy;
+}
+
+void
+equinox_frame_get_stats (EquinoxFrameStats *stats)
+{
+	*stats = frame_stats;
+}
+
+void
+equinox_frame_print_stats (void)
+{
+	g_printerr ("equinox: frames: %lu, %lu cairo contexts created, %lu reused, %lu outside a frame, widget parameters %lu reused, %lu resolved\n",
+	            frame_stats.frames, frame_stats.contexts, frame_stats.context_reuses, frame_stats.unpooled,
+	            frame_stats.params_hits, frame_stats.params_misses);
+}
+
+void
+equinox_frame_cleanup (void)
+{
+	if (teardown_id) {
+		g_source_remove (teardown_id);
+		teardown_id = 0;
+	}
+
+	if (frames) {
+		g_hash_table_destroy (frames);
+		frames = NULL;
+	}
+}
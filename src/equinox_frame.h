@@ -0,0 +1,59 @@
+/* Equinox Engine
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef EQUINOX_FRAME_H
+#define EQUINOX_FRAME_H
+
+#include <gtk/gtk.h>
+#include <cairo.h>
+
+#include "equinox_types.h"
+
+/* Per-window state for one paint cycle: the cairo context and the widget
+ * parameters resolved so far.  Everything is dropped again before the
+ * main loop dispatches anything else. */
+
+typedef struct {
+	gulong frames;
+	gulong contexts;	/* cairo contexts created */
+	gulong context_reuses;
+	gulong unpooled;	/* drawn outside a window frame */
+	gulong params_hits;
+	gulong params_misses;
+} EquinoxFrameStats;
+
+/* Called once on a newly created context */
+typedef void (*EquinoxFrameSetupFunc) (cairo_t *cr);
+
+/* Returns NULL for drawables other than windows; the caller then creates
+ * and destroys a context of its own */
+G_GNUC_INTERNAL cairo_t          *equinox_frame_begin_paint (GdkDrawable *window, EquinoxFrameSetupFunc setup);
+/* Returns FALSE if cr did not come from equinox_frame_begin_paint */
+G_GNUC_INTERNAL gboolean          equinox_frame_end_paint (cairo_t *cr);
+
+G_GNUC_INTERNAL WidgetParameters *equinox_frame_lookup_params (GdkDrawable *window, const GtkWidget *widget,
+                                                              const GtkStyle *style, GtkStateType state_type);
+G_GNUC_INTERNAL WidgetParameters *equinox_frame_insert_params (GdkDrawable *window, const GtkWidget *widget,
+                                                              const GtkStyle *style, GtkStateType state_type,
+                                                              const WidgetParameters *params);
+
+G_GNUC_INTERNAL void              equinox_frame_get_stats (EquinoxFrameStats *stats);
+G_GNUC_INTERNAL void              equinox_frame_print_stats (void);
+G_GNUC_INTERNAL void              equinox_frame_cleanup (void);
+
+#endif /* EQUINOX_FRAME_H */
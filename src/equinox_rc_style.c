@@ -31,9 +31,7 @@
 #include "animation.h"
 
 static void      equinox_rc_style_init         (EquinoxRcStyle      *style);
-#ifdef HAVE_ANIMATION
 static void      equinox_rc_style_finalize     (GObject                *object);
-#endif
 static void      equinox_rc_style_class_init   (EquinoxRcStyleClass *klass);
 static GtkStyle *equinox_rc_style_create_style (GtkRcStyle             *rc_style);
 static guint     equinox_rc_style_parse        (GtkRcStyle             *rc_style,
@@ -70,6 +68,8 @@ enum {
 	TOKEN_TEXTSTYLE,
 	TOKEN_TEXTSHADE,
 	TOKEN_ANIMATION,
+	TOKEN_ANIMATIONLIMIT,
+	TOKEN_ANIMATIONBUDGET,
 	TOKEN_ARROWSIZE,
 	TOKEN_TRUE,
 	TOKEN_FALSE
@@ -103,6 +103,8 @@ theme_symbols[] = {
 	{ "textstyle", TOKEN_TEXTSTYLE },
 	{ "textshade", TOKEN_TEXTSHADE },
 	{ "animation", TOKEN_ANIMATION },
+	{ "animationlimit", TOKEN_ANIMATIONLIMIT },
+	{ "animationbudget", TOKEN_ANIMATIONBUDGET },
 	{ "arrowsize", TOKEN_ARROWSIZE },
 	{ "TRUE", TOKEN_TRUE },
 	{ "FALSE", TOKEN_FALSE }
@@ -152,10 +154,11 @@ static void equinox_rc_style_init (EquinoxRcStyle *equinox_rc) {
 	equinox_rc->textstyle = 0;
 	equinox_rc->textshade = 1.12;
 	equinox_rc->animation = FALSE;
+	equinox_rc->animationlimit = ANIMATION_LIMIT;
+	equinox_rc->animationbudget = ANIMATION_BUDGET;
 	equinox_rc->arrowsize = 1.0;
 }
 
-#ifdef HAVE_ANIMATION
 static void
 equinox_rc_style_finalize (GObject *object)
 {
@@ -165,16 +168,13 @@ equinox_rc_style_finalize (GObject *object)
 	if (G_OBJECT_CLASS (parent_class)->finalize != NULL)
 		G_OBJECT_CLASS (parent_class)->finalize(object);
 }
-#endif
 
 
 static void
 equinox_rc_style_class_init (EquinoxRcStyleClass *klass)
 {
   GtkRcStyleClass *rc_style_class = GTK_RC_STYLE_CLASS (klass);
-#ifdef HAVE_ANIMATION
   GObjectClass    *g_object_class = G_OBJECT_CLASS (klass);
-#endif
 
   parent_class = g_type_class_peek_parent (klass);
 
@@ -182,9 +182,7 @@ equinox_rc_style_class_init (EquinoxRcStyleClass *klass)
   rc_style_class->create_style = equinox_rc_style_create_style;
   rc_style_class->merge = equinox_rc_style_merge;
 
-#ifdef HAVE_ANIMATION
   g_object_class->finalize = equinox_rc_style_finalize;
-#endif
 }
 
 static guint
@@ -302,6 +300,30 @@ theme_parse_int (GtkSettings  *settings,
   return G_TOKEN_NONE;
 }
 
+/* A count of animations, 0 for no limit, larger ones are clamped */
+static guint
+theme_parse_limit (GtkSettings  *settings,
+		         GScanner     *scanner,
+		         guint        *limit)
+{
+  guint token;
+
+  /* Skip 'parameter name' */
+  token = g_scanner_get_next_token(scanner);
+
+  token = g_scanner_get_next_token(scanner);
+  if (token != G_TOKEN_EQUAL_SIGN)
+    return G_TOKEN_EQUAL_SIGN;
+
+  token = g_scanner_get_next_token(scanner);
+  if (token != G_TOKEN_INT)
+    return G_TOKEN_INT;
+
+  *limit = MIN (scanner->value.v_int, MAX_ANIMATION_LIMIT);
+
+  return G_TOKEN_NONE;
+}
+
 static guint
 theme_parse_shade (GtkSettings  *settings,
 		         GScanner     *scanner,
@@ -511,6 +533,14 @@ equinox_rc_style_parse (GtkRcStyle *rc_style,
 				token = theme_parse_boolean (settings, scanner, &equinox_style->animation);
 				equinox_style->flags |= EQX_FLAG_ANIMATION;
 				break;
+			case TOKEN_ANIMATIONLIMIT:
+				token = theme_parse_limit (settings, scanner, &equinox_style->animationlimit);
+				equinox_style->flags |= EQX_FLAG_ANIMATIONLIMIT;
+				break;
+			case TOKEN_ANIMATIONBUDGET:
+				token = theme_parse_curvature (settings, scanner, &equinox_style->animationbudget);
+				equinox_style->flags |= EQX_FLAG_ANIMATIONBUDGET;
+				break;
 			case TOKEN_ARROWSIZE:
 				token = theme_parse_curvature (settings, scanner, &equinox_style->arrowsize);
 				equinox_style->flags |= EQX_FLAG_ARROWSIZE;
@@ -593,6 +623,10 @@ static void equinox_rc_style_merge (GtkRcStyle *dest, GtkRcStyle *src) {
 		dest_w->textshade = src_w->textshade;
 	if (flags & EQX_FLAG_ANIMATION)
 		dest_w->animation = src_w->animation;
+	if (flags & EQX_FLAG_ANIMATIONLIMIT)
+		dest_w->animationlimit = src_w->animationlimit;
+	if (flags & EQX_FLAG_ANIMATIONBUDGET)
+		dest_w->animationbudget = src_w->animationbudget;
 	if (flags & EQX_FLAG_ARROWSIZE)
 		dest_w->arrowsize = src_w->arrowsize;
 
@@ -63,7 +63,9 @@ typedef enum {
 	EQX_FLAG_ANIMATION = 1 << 20,
 	EQX_FLAG_ARROWSIZE = 1 << 21,
 	EQX_FLAG_MENUBARBORDERS = 1 << 22,
-	EQX_FLAG_LISTVIEWITEMSTYLE = 1 << 23
+	EQX_FLAG_LISTVIEWITEMSTYLE = 1 << 23,
+	EQX_FLAG_ANIMATIONLIMIT = 1 << 24,
+	EQX_FLAG_ANIMATIONBUDGET = 1 << 25
 } EquinoxRcFlags;
 
 struct _EquinoxRcStyle {
@@ -95,6 +97,8 @@ struct _EquinoxRcStyle {
 	guint8 textstyle;
 	double textshade;
 	gboolean animation;
+	guint animationlimit;
+	gdouble animationbudget;
 	gdouble arrowsize;
 };
 
@@ -6,13 +6,16 @@
 #include "equinox_style.h"
 #include "equinox_rc_style.h"
 #include "equinox_draw.h"
+#include "equinox_cache.h"
+#include "equinox_detail.h"
+#include "equinox_frame.h"
 #include "support.h"
 
 static EquinoxStyleClass *equinox_style_class;
 static GtkStyleClass *equinox_parent_class;
 
 
-#define DETAIL(xx)   ((detail) && (!strcmp(xx, detail)))
+#define DETAIL(xx)   (eqx_detail == EQX_DETAIL_##xx)
 
 #define DRAW_ARGS    GtkStyle       *style, \
                      GdkWindow      *window, \
@@ -42,9 +45,7 @@ static GtkStyleClass *equinox_parent_class;
     gdk_drawable_get_size (window, NULL, &height);
 
 
-#ifdef HAVE_ANIMATION
 #include "animation.h"
-#endif
 
 const static int FRAME_SHADE = 5;
 
@@ -84,6 +85,14 @@ clearlooks_rounded_rectangle (cairo_t * cr,
     cairo_line_to (cr, x, y);
 }
 
+static void
+equinox_setup_paint (cairo_t * cr)
+{
+  cairo_set_line_width (cr, 1.0);
+  cairo_set_line_cap (cr, CAIRO_LINE_CAP_SQUARE);
+  cairo_set_line_join (cr, CAIRO_LINE_JOIN_MITER);
+}
+
 static cairo_t *
 equinox_begin_paint (GdkDrawable * window, GdkRectangle * area)
 {
@@ -91,27 +100,44 @@ equinox_begin_paint (GdkDrawable * window, GdkRectangle * area)
 
   g_return_val_if_fail (window != NULL, NULL);
 
-  cr = (cairo_t *) gdk_cairo_create (window);
-  cairo_set_line_width (cr, 1.0);
-  cairo_set_line_cap (cr, CAIRO_LINE_CAP_SQUARE);
-  cairo_set_line_join (cr, CAIRO_LINE_JOIN_MITER);
+  /* A pooled context already comes with the defaults set */
+  cr = equinox_frame_begin_paint (window, equinox_setup_paint);
+  if (cr == NULL) {
+    cr = (cairo_t *) gdk_cairo_create (window);
+    equinox_setup_paint (cr);
+  }
 
   if (area) {
     cairo_rectangle (cr, area->x, area->y, area->width, area->height);
-    cairo_clip_preserve (cr);
-    cairo_new_path (cr);
+    cairo_clip (cr);
   }
 
   return cr;
 }
 
+static void
+equinox_end_paint (cairo_t * cr)
+{
+  if (!equinox_frame_end_paint (cr))
+    cairo_destroy (cr);
+}
+
 
 static void
-equinox_set_widget_parameters (const GtkWidget * widget,
+equinox_set_widget_parameters (GdkWindow * window,
+			      const GtkWidget * widget,
 			      const GtkStyle * style,
 			      GtkStateType state_type,
 			      WidgetParameters * params)
 {
+  WidgetParameters *memo;
+
+  /* Already resolved for an earlier call in this expose */
+  memo = equinox_frame_lookup_params (window, widget, style, state_type);
+  if (memo) {
+    *params = *memo;
+    return;
+  }
 
   params->active = (state_type == GTK_STATE_ACTIVE);
   params->prelight = (state_type == GTK_STATE_PRELIGHT);
@@ -123,7 +149,6 @@ equinox_set_widget_parameters (const GtkWidget * widget,
   params->is_default = widget && GTK_WIDGET_HAS_DEFAULT (widget);
   params->trans = 1.0;
   params->prev_state_type = state_type;
-  params->ltr = equinox_widget_is_ltr ((GtkWidget*)widget);
   //params->composited = gtk_widget_is_composited ((GtkWidget*)widget);
 
   if (!params->active && widget && GTK_IS_TOGGLE_BUTTON (widget))
@@ -132,16 +157,41 @@ equinox_set_widget_parameters (const GtkWidget * widget,
   params->xthickness = style->xthickness;
   params->ythickness = style->ythickness;
 
-  if (widget)
-    equinox_get_parent_bg (widget, &params->parentbg);
+  /* Only looked up if the draw function asks for them */
+  params->own_lazy.source = widget;
+  params->own_lazy.pending = EQX_PARAM_PARENTBG | EQX_PARAM_LTR;
+  params->own_lazy.parentbg = EQUINOX_STYLE (style)->colors.bg[GTK_STATE_NORMAL];
+  params->lazy = &params->own_lazy;
 
+  equinox_params_count_setup ();
 
+  memo = equinox_frame_insert_params (window, widget, style, state_type, params);
+  if (memo)
+    params->lazy = memo->lazy;
+}
+
+/* Fade from the state the widget's running transition started in; leaves
+ * params alone if animation is off or the widget is not animated. */
+static void
+equinox_apply_animation (const EquinoxAnimationHooks *hooks,
+			 const GtkWidget *widget,
+			 WidgetParameters *params,
+			 gdouble duration)
+{
+  EquinoxAnimationState animation;
+
+  if (hooks == NULL || !hooks->lookup ((gpointer) widget, &animation))
+    return;
+
+  params->trans = sqrt (sqrt (MIN (animation.elapsed / duration, 1.0)));
+  params->prev_state_type = animation.starting_state_type;
 }
 
 static void
 equinox_style_draw_flat_box (DRAW_ARGS) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_FLAT_BOX);
 
-	if (DETAIL ("tooltip")) {
+	if (DETAIL (TOOLTIP)) {
 		WidgetParameters params;
 		EquinoxStyle *equinox_style;
 		EquinoxColors *colors;
@@ -150,14 +200,14 @@ equinox_style_draw_flat_box (DRAW_ARGS) {
 		CHECK_ARGS
 		SANITIZE_SIZE
 		equinox_style = EQUINOX_STYLE (style);
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		colors = &equinox_style->colors;
 		cr = equinox_begin_paint (window, area);
 
 		equinox_draw_tooltip (cr, colors, &params, x, y, width, height);
-		cairo_destroy (cr);
-	} else if (DETAIL ("text")) {
-	} else if (detail && state_type == GTK_STATE_SELECTED && (!strncmp ("cell_even", detail, 9) || !strncmp ("cell_odd", detail, 8))) {
+		equinox_end_paint (cr);
+	} else if (DETAIL (TEXT)) {
+	} else if (state_type == GTK_STATE_SELECTED && (DETAIL (CELL_EVEN) || DETAIL (CELL_ODD))) {
 		WidgetParameters params;
 		EquinoxStyle *equinox_style;
 		EquinoxColors *colors;
@@ -167,13 +217,13 @@ equinox_style_draw_flat_box (DRAW_ARGS) {
 		SANITIZE_SIZE
 		equinox_style = EQUINOX_STYLE (style);
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		colors = &equinox_style->colors;
 
 		cr = equinox_begin_paint (window, area);
 		equinox_draw_list_selection (cr, colors, &params, x, y, width, height);
-		cairo_destroy (cr);
-	} else if (DETAIL ("expander") || DETAIL ("checkbutton")) {
+		equinox_end_paint (cr);
+	} else if (DETAIL (EXPANDER) || DETAIL (CHECKBUTTON)) {
 		WidgetParameters params;
 		EquinoxStyle *equinox_style;
 		EquinoxColors *colors;
@@ -183,7 +233,7 @@ equinox_style_draw_flat_box (DRAW_ARGS) {
 		SANITIZE_SIZE
 		equinox_style = EQUINOX_STYLE (style);
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		colors = &equinox_style->colors;
 		cr = equinox_begin_paint (window, area);
 
@@ -191,13 +241,13 @@ equinox_style_draw_flat_box (DRAW_ARGS) {
 
 		// Focus colour lighter than parentbg
 		EquinoxRGB focus_color;
-		equinox_shade (&params.parentbg, &focus_color, equinox_get_lightness(&params.parentbg) < 0.6 ? 1.24 : 1.05);
+		equinox_shade (equinox_params_parentbg (&params), &focus_color, equinox_get_lightness(equinox_params_parentbg (&params)) < 0.6 ? 1.24 : 1.05);
 		cairo_set_source_rgb (cr, focus_color.r, focus_color.g, focus_color.b);
 		clearlooks_rounded_rectangle (cr, 0, 0, width, height, params.curvature + 2, EQX_CORNER_ALL);
 		cairo_fill (cr);
 
-		cairo_destroy (cr);
-	} else if (detail && (strncmp ("cell_even", detail, 9) || strncmp ("cell_odd", detail, 8)) && widget && EQUINOX_IS_TREE_VIEW(widget)) {
+		equinox_end_paint (cr);
+	} else if (detail && widget && EQUINOX_IS_TREE_VIEW(widget)) {
 		WidgetParameters params;
 		EquinoxStyle *equinox_style;
 		EquinoxColors *colors;
@@ -207,12 +257,12 @@ equinox_style_draw_flat_box (DRAW_ARGS) {
 		SANITIZE_SIZE
 		equinox_style = EQUINOX_STYLE (style);
 		if (equinox_style->listviewitemstyle == 1 && GTK_IS_TREE_VIEW(widget) && gtk_tree_view_get_rules_hint(GTK_TREE_VIEW(widget))) {
-			equinox_set_widget_parameters (widget, style, state_type, &params);
+			equinox_set_widget_parameters (window, widget, style, state_type, &params);
 			colors = &equinox_style->colors;
 
 			cr = equinox_begin_paint (window, area);
 			equinox_draw_list_item (cr, colors, &params, x, y, width, height, equinox_style->listviewitemstyle);
-			cairo_destroy (cr);
+			equinox_end_paint (cr);
 		} else  {
 			equinox_parent_class->draw_flat_box (style, window, state_type,	shadow_type, area, widget, detail, x, y, width, height);
 		}
@@ -222,6 +272,7 @@ equinox_style_draw_flat_box (DRAW_ARGS) {
 }
 
 static void equinox_style_draw_shadow (DRAW_ARGS) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_SHADOW);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -231,20 +282,20 @@ static void equinox_style_draw_shadow (DRAW_ARGS) {
 	cr = equinox_begin_paint (window, area);
 
 
-	if (((DETAIL ("entry") && !(widget && EQUINOX_IS_TREE_VIEW (widget->parent))) ||
-	    (DETAIL ("frame") && equinox_is_in_combo_box (widget))) && shadow_type != GTK_SHADOW_NONE) {
+	if (((DETAIL (ENTRY) && !(widget && EQUINOX_IS_TREE_VIEW (widget->parent))) ||
+	    (DETAIL (FRAME) && equinox_widget_in_combo_box (widget))) && shadow_type != GTK_SHADOW_NONE) {
 		WidgetParameters params;
 		EntryParameters entry;
 		//entry.isCombo = FALSE;
 		entry.type = EQX_ENTRY_NORMAL;
 		entry.isComboButton = FALSE;
 		entry.isSpinButton = FALSE;
-		if (equinox_is_toolbar_item (widget))
+		if (EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_TOOLBAR_ITEM))
 			entry.isToolbarItem = TRUE;
 		else
 			entry.isToolbarItem = FALSE;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 		if (EQUINOX_IS_ENTRY (widget))
 			params.state_type = GTK_WIDGET_STATE (widget);
@@ -254,6 +305,13 @@ static void equinox_style_draw_shadow (DRAW_ARGS) {
 		params.disabled = (params.state_type == GTK_STATE_INSENSITIVE);
 		//params.curvature = 0;
 
+		const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
+
+		if (hooks && EQUINOX_IS_ENTRY (widget)) {
+			hooks->connect_entry (widget);
+			equinox_apply_animation (hooks, widget, &params, ANIMATION_TRANS_TIME);
+		}
+
 		if (widget && (EQUINOX_IS_COMBO (widget->parent) ||
 				EQUINOX_IS_COMBO_BOX_ENTRY (widget->parent) ||
 				EQUINOX_IS_SPIN_BUTTON (widget))) {
@@ -263,10 +321,10 @@ static void equinox_style_draw_shadow (DRAW_ARGS) {
 
 
 			width += style->xthickness;
-			if (!params.ltr)
+			if (!equinox_params_ltr (&params))
 				x -= style->xthickness;
 
-			if (params.ltr)
+			if (equinox_params_ltr (&params))
 				params.corners = EQX_CORNER_TOPLEFT | EQX_CORNER_BOTTOMLEFT;
 			else
 				params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_BOTTOMRIGHT;
@@ -280,9 +338,9 @@ static void equinox_style_draw_shadow (DRAW_ARGS) {
 		}
 
 		equinox_draw_entry (cr, colors, &params, &entry, x, y, width, height, equinox_style->toolbarstyle);
-	} else if (DETAIL ("frame") && widget && EQUINOX_IS_STATUSBAR (widget->parent) && shadow_type != GTK_SHADOW_NONE) {
+	} else if (DETAIL (FRAME) && widget && EQUINOX_IS_STATUSBAR (widget->parent) && shadow_type != GTK_SHADOW_NONE) {
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		SeparatorParameters separator;
 		separator.horizontal = TRUE;
 
@@ -297,7 +355,7 @@ static void equinox_style_draw_shadow (DRAW_ARGS) {
 		cairo_restore(cr);
 		// Uncomment the following line to draw a separator at the top of the statusbar
 		//equinox_draw_separator (cr, colors, &params, &separator, x, y, width, 2);
-	} else if (widget && widget->parent && widget->parent->parent && EQUINOX_IS_COLOR_BUTTON (widget->parent->parent)) {
+	} else if (EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_COLOR_SWATCH)) {
 		EquinoxRGB border;
 		GdkColor button_color;
 
@@ -315,14 +373,14 @@ static void equinox_style_draw_shadow (DRAW_ARGS) {
 		cairo_set_source_rgba (cr, border.r, border.g, border.b, 0.2);
 		clearlooks_rounded_rectangle (cr, x + 2.5, y + 2.5, width - 3, height - 3, 3, EQX_CORNER_ALL);
 		cairo_stroke (cr);
-	} else if (DETAIL ("pager") || DETAIL ("pager-frame")) {
+	} else if (DETAIL (PAGER) || DETAIL (PAGER_FRAME)) {
     EquinoxRGB border;
 
 		equinox_mix_color (&colors->shade[7], &colors->bg[GTK_STATE_SELECTED], 0.15, &border);
 		cairo_set_source_rgb (cr, border.r, border.g, border.b);
 		clearlooks_rounded_rectangle (cr, x + 0.5, y + 0.5, width - 1, height - 1, 2, EQX_CORNER_ALL);
 		cairo_stroke (cr);
-	} else if (DETAIL ("frame") || DETAIL ("scrolled_window") || DETAIL ("viewport") || detail == NULL) {
+	} else if (DETAIL (FRAME) || DETAIL (SCROLLED_WINDOW) || DETAIL (VIEWPORT) || detail == NULL) {
 		if (widget && !g_str_equal ("XfcePanelWindow", gtk_widget_get_name (gtk_widget_get_toplevel (widget))) && shadow_type != GTK_SHADOW_NONE) {
 			cairo_rectangle (cr, x + 0.5, y + 0.5, width - 1, height - 1);
 			cairo_set_source_rgb (cr, colors->shade[FRAME_SHADE].r, colors->shade[FRAME_SHADE].g, colors->shade[FRAME_SHADE].b);
@@ -333,10 +391,11 @@ static void equinox_style_draw_shadow (DRAW_ARGS) {
 		cairo_set_source_rgb (cr, colors->shade[FRAME_SHADE].r, colors->shade[FRAME_SHADE].g, colors->shade[FRAME_SHADE].b);
 		cairo_stroke (cr);
 	}
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_box_gap (DRAW_ARGS, GtkPositionType gap_side, gint gap_x, gint gap_width) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_BOX_GAP);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -345,7 +404,7 @@ static void equinox_style_draw_box_gap (DRAW_ARGS, GtkPositionType gap_side, gin
 	SANITIZE_SIZE
 	cr = equinox_begin_paint (window, area);
 
-	if (DETAIL ("notebook")) {
+	if (DETAIL (NOTEBOOK)) {
 		WidgetParameters params;
 		FrameParameters frame;
 
@@ -359,7 +418,7 @@ static void equinox_style_draw_box_gap (DRAW_ARGS, GtkPositionType gap_side, gin
 		frame.fill = &colors->bg[state_type];
 		frame.use_fill = TRUE;
 		frame.fill_bg = TRUE;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		params.curvature = MIN(params.curvature, MIN(params.xthickness, params.ythickness) + 1.5);
 
 		//Don't round top corner when the border tab is selected.
@@ -372,12 +431,12 @@ static void equinox_style_draw_box_gap (DRAW_ARGS, GtkPositionType gap_side, gin
 			if ((current_page == 0) && (num_pages - 1 == 0)) {
 					params.corners = EQX_CORNER_BOTTOMRIGHT | EQX_CORNER_BOTTOMLEFT;
 			} else if (current_page == 0) {
-				if(params.ltr)
+				if(equinox_params_ltr (&params))
 					params.corners =EQX_CORNER_BOTTOMRIGHT | EQX_CORNER_BOTTOMLEFT | EQX_CORNER_TOPRIGHT;
 				else
 					params.corners =EQX_CORNER_BOTTOMRIGHT | EQX_CORNER_BOTTOMLEFT | EQX_CORNER_TOPLEFT;
 			} else if (current_page == num_pages - 1) {
-				if(params.ltr)
+				if(equinox_params_ltr (&params))
 					params.corners = EQX_CORNER_BOTTOMRIGHT | EQX_CORNER_BOTTOMLEFT | EQX_CORNER_TOPLEFT;
 				else
 					params.corners =EQX_CORNER_BOTTOMRIGHT | EQX_CORNER_BOTTOMLEFT | EQX_CORNER_TOPRIGHT;
@@ -387,12 +446,12 @@ static void equinox_style_draw_box_gap (DRAW_ARGS, GtkPositionType gap_side, gin
 			if ((current_page == 0) && (num_pages - 1 == 0)) {
 				params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_TOPLEFT;
 			} else if (current_page == 0) {
-				if(params.ltr)
+				if(equinox_params_ltr (&params))
 					params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_TOPLEFT | EQX_CORNER_BOTTOMRIGHT;
 				else
 					params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_BOTTOMLEFT | EQX_CORNER_TOPLEFT;
 			} else if (current_page == num_pages - 1) {
-				if(params.ltr)
+				if(equinox_params_ltr (&params))
 					params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_BOTTOMLEFT | EQX_CORNER_TOPLEFT;
 				else
 					params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_TOPLEFT | EQX_CORNER_BOTTOMRIGHT;
@@ -427,10 +486,11 @@ static void equinox_style_draw_box_gap (DRAW_ARGS, GtkPositionType gap_side, gin
 	} else
 		equinox_parent_class->draw_box_gap (style, window, state_type, shadow_type, area, widget, detail, x, y, width, height, gap_side, gap_x, gap_width);
 
-  	cairo_destroy (cr);
+  	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_extension (DRAW_ARGS, GtkPositionType gap_side) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_EXTENSION);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -439,24 +499,24 @@ static void equinox_style_draw_extension (DRAW_ARGS, GtkPositionType gap_side) {
 	SANITIZE_SIZE
 	cr = equinox_begin_paint (window, area);
 
-	if (DETAIL ("tab"))	{
+	if (DETAIL (TAB))	{
 		WidgetParameters params;
 		TabParameters tab;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		tab.gap_side = (EquinoxGapSide) gap_side;
 
 		int current_page = gtk_notebook_get_current_page ((GtkNotebook *) widget);
 		int num_of_pages = gtk_notebook_get_n_pages ((GtkNotebook *) widget);
 
 		if (current_page == 0)
-			tab.first_tab = (params.ltr || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? TRUE : FALSE;
+			tab.first_tab = (equinox_params_ltr (&params) || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? TRUE : FALSE;
 		else
-			tab.first_tab = (params.ltr || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? FALSE : TRUE;
+			tab.first_tab = (equinox_params_ltr (&params) || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? FALSE : TRUE;
 		if (num_of_pages - 1 == current_page)
-			tab.last_tab = (params.ltr || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? TRUE : FALSE;
+			tab.last_tab = (equinox_params_ltr (&params) || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? TRUE : FALSE;
 		else
-			tab.last_tab = (params.ltr || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? FALSE : TRUE;
+			tab.last_tab = (equinox_params_ltr (&params) || (tab.gap_side == EQX_GAP_LEFT || tab.gap_side == EQX_GAP_RIGHT)) ? FALSE : TRUE;
 
 		if (num_of_pages == 1)
 			tab.last_tab = tab.first_tab = TRUE;
@@ -468,10 +528,11 @@ static void equinox_style_draw_extension (DRAW_ARGS, GtkPositionType gap_side) {
 		equinox_parent_class->draw_extension (style, window, state_type, shadow_type, area, widget, detail, x, y, width, height, gap_side);
 
 	}
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_handle (DRAW_ARGS, GtkOrientation orientation) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_HANDLE);
 
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
@@ -485,12 +546,12 @@ static void equinox_style_draw_handle (DRAW_ARGS, GtkOrientation orientation) {
 	WidgetParameters params;
 	HandleParameters handle;
 
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 	// Evil hack to work around broken orientation for toolbars
 	is_horizontal = (width > height);
 
-	if (DETAIL ("handlebox")) {
+	if (DETAIL (HANDLEBOX)) {
 		handle.type = EQX_HANDLE_TOOLBAR;
 		handle.horizontal = is_horizontal;
 
@@ -502,7 +563,7 @@ static void equinox_style_draw_handle (DRAW_ARGS, GtkOrientation orientation) {
 		}
 
 		equinox_draw_handle (cr, colors, &params, &handle, x, y, width, height);
-	} else if (DETAIL ("paned")) {
+	} else if (DETAIL (PANED)) {
 		handle.type = EQX_HANDLE_SPLITTER;
 		handle.horizontal = orientation == GTK_ORIENTATION_HORIZONTAL;
 
@@ -519,10 +580,11 @@ static void equinox_style_draw_handle (DRAW_ARGS, GtkOrientation orientation) {
 
 		equinox_draw_handle (cr, colors, &params, &handle, x, y, width, height);
   }
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_box (DRAW_ARGS) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_BOX);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 
@@ -531,11 +593,11 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 	cairo_t *cr = equinox_begin_paint (window, area);
 
 
-	if (DETAIL ("menubar") && !equinox_is_panel_widget_item(widget)) {
+	if (DETAIL (MENUBAR) && !EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_PANEL_ITEM)) {
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		equinox_draw_menubar (cr, colors, &params, x, y, width, height, equinox_style->menubarstyle, equinox_style->menubarborders);
-	} else if (DETAIL ("button") && widget && widget->parent && (EQUINOX_IS_TREE_VIEW(widget->parent) || EQUINOX_IS_CLIST (widget->parent)  || equinox_object_is_a (G_OBJECT (widget->parent), "ETree") || /* ECanvas inside ETree */ equinox_object_is_a (G_OBJECT (widget->parent), "ETable") /* ECanvas inside ETable */ )) {
+	} else if (DETAIL (BUTTON) && EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_TREE_HEADER)) { /* also ECanvas inside ETree/ETable */
 		WidgetParameters params;
 		ListViewHeaderParameters header;
 
@@ -545,7 +607,7 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 		columns = 3;
 		column_index = 1;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		params.corners = EQX_CORNER_NONE;
 
 		if (EQUINOX_IS_TREE_VIEW (widget->parent))
@@ -565,37 +627,27 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 
     	gtk_style_apply_default_background (style, window, FALSE, state_type, area, x, y, width, height);
 
-#ifdef HAVE_ANIMATION
-		if (equinox_style->animation) {
-			equinox_animation_connect_button (widget);
-			params.prev_state_type = equinox_animation_starting_state (widget);
-		}
+		const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
 
-		if (equinox_style->animation && GTK_IS_BUTTON (widget) && equinox_animation_is_animated (widget)) {
-			gfloat elapsed = equinox_animation_elapsed (widget);
-			params.prev_state_type = equinox_animation_starting_state (widget);
-			params.trans = sqrt (sqrt (MIN(elapsed / ANIMATION_TRANS_TIME, 1.0)));
+		if (hooks) {
+			hooks->connect_button (widget);
+			if (GTK_IS_BUTTON (widget))
+				equinox_apply_animation (hooks, widget, &params, ANIMATION_TRANS_TIME);
 		}
-#endif
 
 		equinox_draw_list_view_header (cr, colors, &params, &header, x, y, width, height, equinox_style->listviewheaderstyle);
 
-	} else if (DETAIL ("button") || DETAIL ("buttondefault")) {
+	} else if (DETAIL (BUTTON) || DETAIL (BUTTONDEFAULT)) {
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
-#ifdef HAVE_ANIMATION
-		if (equinox_style->animation && !(widget && widget->parent && widget->parent->parent && EQUINOX_IS_PANEL_WIDGET(widget->parent->parent))) {
-			equinox_animation_connect_button (widget);
-			params.prev_state_type = equinox_animation_starting_state (widget);
-		}
+		const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
 
-		if (equinox_style->animation && GTK_IS_BUTTON (widget) && equinox_animation_is_animated (widget)) {
-			gfloat elapsed = equinox_animation_elapsed (widget);
-			params.prev_state_type = equinox_animation_starting_state (widget);
-			params.trans = sqrt (sqrt (MIN(elapsed / ANIMATION_TRANS_TIME, 1.0)));
+		if (hooks && !EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_PANEL_BUTTON)) {
+			hooks->connect_button (widget);
+			if (GTK_IS_BUTTON (widget))
+				equinox_apply_animation (hooks, widget, &params, ANIMATION_TRANS_TIME);
 		}
-#endif
 
 		if ((widget && (EQUINOX_IS_COMBO_BOX_ENTRY (widget->parent) || EQUINOX_IS_COMBO (widget->parent)))) {
 
@@ -603,7 +655,7 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 			if (EQUINOX_IS_COMBO (widget->parent))
 				params.focus |= GTK_WIDGET_HAS_FOCUS (((GtkCombo*)widget->parent)->entry);
 
-			if (params.ltr) {
+			if (equinox_params_ltr (&params)) {
 				params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_BOTTOMRIGHT;
 				x -= 2;
 				width += 2;
@@ -621,7 +673,7 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 		/*if (EQUINOX_IS_BUTTON (widget) && EQUINOX_IS_FIXED (widget->parent) && widget->allocation.x == -1 &&  widget->allocation.y == -1)
 				gtk_style_apply_default_background (widget->parent->style, window, TRUE, GTK_STATE_NORMAL, area, x, y, width, height);*/
 
-		if (EQUINOX_IS_PANEL_WIDGET(widget->parent->parent)) {	//for task list
+		if (EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_PANEL_BUTTON)) {	//for task list
 			params.corners = EQX_CORNER_TOPLEFT | EQX_CORNER_TOPRIGHT;
 			height += 3;
 		}
@@ -647,16 +699,16 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 		} else {
 	  	equinox_draw_button (cr, &equinox_style->colors, &params, x, y, width, height, equinox_style->buttonstyle);
 	  }
-	} else if (DETAIL ("spinbutton_up") || DETAIL ("spinbutton_down")) {
+	} else if (DETAIL (SPINBUTTON_UP) || DETAIL (SPINBUTTON_DOWN)) {
 
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 		EntryParameters entry;
 		entry.type = EQX_ENTRY_SPINBUTTON;
 		entry.isComboButton = FALSE;
 		entry.isSpinButton = TRUE;
-		if (equinox_is_toolbar_item (widget))
+		if (EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_TOOLBAR_ITEM))
 			entry.isToolbarItem = TRUE;
 		else
 			entry.isToolbarItem = FALSE;
@@ -667,7 +719,7 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 			params.state_type = GTK_STATE_NORMAL;
 		}
 
-		if (params.ltr) {
+		if (equinox_params_ltr (&params)) {
 			x -= 2;
 			width += 2;
 			params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_BOTTOMRIGHT;
@@ -677,25 +729,25 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 		}
 
 		/*more faking of real transparancy.*/
-		cairo_set_source_rgb (cr, params.parentbg.r, params.parentbg.g, params.parentbg.b);
+		equinox_set_source_rgb (cr, equinox_params_parentbg (&params));
 		cairo_rectangle (cr, x, y, width, height);
 		cairo_fill_preserve(cr);
 		cairo_clip(cr);
 
-	 	if (DETAIL ("spinbutton_up")) {
+	 	if (DETAIL (SPINBUTTON_UP)) {
 			equinox_draw_entry (cr, &equinox_style->colors, &params, &entry, x, y, width, height*2, equinox_style->toolbarstyle);
 		} else {
 			equinox_draw_entry (cr, &equinox_style->colors, &params, &entry, x, y - height, width, height*2, equinox_style->toolbarstyle);
 		}
-  	} else if (DETAIL ("spinbutton")) {
-	} else if (DETAIL ("trough") && widget && GTK_IS_SCALE (widget)) {
+  	} else if (DETAIL (SPINBUTTON)) {
+	} else if (DETAIL (TROUGH) && widget && GTK_IS_SCALE (widget)) {
 		GtkAdjustment *adjustment = gtk_range_get_adjustment (GTK_RANGE (widget));
 		WidgetParameters params;
 		SliderParameters slider;
 		gint slider_length;
 
 		gtk_widget_style_get (widget, "slider-length", &slider_length, NULL);
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 		slider.inverted = gtk_range_get_inverted (GTK_RANGE (widget));
 		slider.horizontal = (GTK_RANGE (widget)->orientation == GTK_ORIENTATION_HORIZONTAL);
@@ -712,20 +764,20 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 		}
 
 		equinox_draw_scale_trough (cr, &equinox_style->colors, &params, &slider, x, y, width, height);
-  	} else if (DETAIL ("trough") && widget && EQUINOX_IS_PROGRESS_BAR (widget)) {
+  	} else if (DETAIL (TROUGH) && widget && EQUINOX_IS_PROGRESS_BAR (widget)) {
 		WidgetParameters params;
 		ProgressBarParameters progressbar;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		//params.curvature = 0;
 
 		progressbar.orientation = gtk_progress_bar_get_orientation (GTK_PROGRESS_BAR (widget));
 
     	equinox_draw_progressbar_trough (cr, colors, &params, &progressbar, x, y, width, height, equinox_style->progressbarstyle);
-	} else if ((DETAIL ("trough") && widget && (EQUINOX_IS_VSCROLLBAR (widget) || EQUINOX_IS_HSCROLLBAR (widget))) || DETAIL ("stepper")) {
+	} else if ((DETAIL (TROUGH) && widget && (EQUINOX_IS_VSCROLLBAR (widget) || EQUINOX_IS_HSCROLLBAR (widget))) || DETAIL (STEPPER)) {
 		WidgetParameters params;
 		ScrollBarParameters scrollbar;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		params.curvature = 0;
 		scrollbar.horizontal = TRUE;
 		//scrollbar.junction = equinox_scrollbar_get_junction (widget);
@@ -733,21 +785,23 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 		if (EQUINOX_IS_RANGE (widget))
 			scrollbar.horizontal = GTK_RANGE (widget)->orientation == GTK_ORIENTATION_HORIZONTAL;
 		equinox_draw_scrollbar_trough (cr, colors, &params, &scrollbar, x, y, width, height, equinox_style->scrollbarstyle, equinox_style->scrollbartrough);
-	} else if (DETAIL ("bar")) {
+	} else if (DETAIL (BAR)) {
 		WidgetParameters params;
 		ProgressBarParameters progressbar;
-		gdouble elapsed = 0.0;
+		gdouble phase = 0.0;
+
+		const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
+		EquinoxAnimationState animation;
 
-#ifdef HAVE_ANIMATION
-		if (equinox_style->animation && EQX_IS_PROGRESS_BAR (widget)) {
+		if (hooks && EQX_IS_PROGRESS_BAR (widget)) {
 			gboolean activity_mode = GTK_PROGRESS (widget)->activity_mode;
 			if (!activity_mode)
-				equinox_animation_progressbar_add ((gpointer) widget);
+				hooks->progressbar_add ((gpointer) widget);
 		}
-		elapsed = equinox_animation_elapsed (widget);
-#endif
+		if (hooks && hooks->lookup (widget, &animation))
+			phase = hooks->progressbar_phase ();
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		//params.curvature = 0;
 
 
@@ -757,30 +811,25 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 		} else
 			progressbar.orientation = EQX_ORIENTATION_LEFT_TO_RIGHT;
 
-		equinox_draw_progressbar_fill (cr, colors, &params, &progressbar, x - 1, y, width + 2, height, 10 - (int) (elapsed * 10) % 10, equinox_style->progressbarstyle);
-	} else if (DETAIL ("optionmenu")) {
+		equinox_draw_progressbar_fill (cr, colors, &params, &progressbar, x - 1, y, width + 2, height, phase, equinox_style->progressbarstyle);
+	} else if (DETAIL (OPTIONMENU)) {
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
-#ifdef HAVE_ANIMATION
-		if (equinox_style->animation) {
-			equinox_animation_connect_button (widget);
-			params.prev_state_type = equinox_animation_starting_state (widget);
-		}
+		const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
 
-		if (equinox_style->animation && GTK_IS_BUTTON (widget) && equinox_animation_is_animated (widget)) {
-			gfloat elapsed = equinox_animation_elapsed (widget);
-			params.prev_state_type = equinox_animation_starting_state (widget);
-			params.trans = sqrt (sqrt (MIN(elapsed / ANIMATION_TRANS_TIME, 1.0)));
+		if (hooks) {
+			hooks->connect_button (widget);
+			if (GTK_IS_BUTTON (widget))
+				equinox_apply_animation (hooks, widget, &params, ANIMATION_TRANS_TIME);
 		}
-#endif
 
 		equinox_draw_button (cr, colors, &params, x, y, width, height, equinox_style->buttonstyle);
 
-	} else if (DETAIL ("menuitem")) {
+	} else if (DETAIL (MENUITEM)) {
 		WidgetParameters params;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		params.corners = EQX_CORNER_NONE;
 
 		//If parent is menubar draw top corners rounded else draw normal
@@ -788,19 +837,27 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 			params.corners = EQX_CORNER_TOPRIGHT | EQX_CORNER_TOPLEFT;
 			params.curvature = (params.curvature > height*0.2) ? height*0.2 : params.curvature;
 			height++;			//hide bottom border so we don't get a double border with menu
-			equinox_draw_menubar_item (cr, colors, &params, x, y, width, height, equinox_style->menubaritemstyle, EQUINOX_IS_PANEL_WIDGET(widget->parent->parent));
+			equinox_draw_menubar_item (cr, colors, &params, x, y, width, height, equinox_style->menubaritemstyle, EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_PANEL_BUTTON));
 		}
 		else {
 			params.corners = EQX_CORNER_ALL;
 			params.curvature = 0;
+
+			const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
+
+			if (hooks) {
+				hooks->connect_menuitem (widget);
+				equinox_apply_animation (hooks, widget, &params, ANIMATION_TRANS_TIME);
+			}
+
 			equinox_draw_menuitem (cr, colors, &params, x, y, width, height, equinox_style->menuitemstyle);
 		}
-	//} else if (DETAIL ("hscrollbar") || DETAIL ("vscrollbar") || DETAIL ("slider") /*|| DETAIL ("stepper")*/) {
-	} else if (DETAIL ("hscrollbar") || DETAIL ("vscrollbar") || DETAIL ("slider")) {
+	//} else if (DETAIL (HSCROLLBAR) || DETAIL (VSCROLLBAR) || DETAIL (SLIDER) /*|| DETAIL (STEPPER)*/) {
+	} else if (DETAIL (HSCROLLBAR) || DETAIL (VSCROLLBAR) || DETAIL (SLIDER)) {
 		WidgetParameters params;
 		ScrollBarParameters scrollbar;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 		params.corners = EQX_CORNER_NONE;
 		scrollbar.has_color = FALSE;
@@ -815,30 +872,40 @@ static void equinox_style_draw_box (DRAW_ARGS) {
 			scrollbar.has_color = TRUE;
 		}
 
-		if (DETAIL ("slider")) {
+		if (DETAIL (SLIDER)) {
 			if (params.curvature >= 1)
 				params.corners = EQX_CORNER_ALL;
 			else
 				params.corners = EQX_CORNER_NONE;
+
+			const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
+
+			/* the scrollbar keeps its state while the slider is lit */
+			if (hooks && GTK_IS_RANGE (widget)) {
+				hooks->track_state (widget, state_type);
+				equinox_apply_animation (hooks, widget, &params, ANIMATION_TRANS_TIME);
+			}
+
 			equinox_draw_scrollbar_slider (cr, colors, &params, &scrollbar, x, y, width, height, equinox_style->scrollbarstyle, equinox_style->scrollbarmargin);
 		}
-	} else if (DETAIL ("toolbar") || DETAIL ("handlebox_bin") || DETAIL ("dockitem_bin")) {
+	} else if (DETAIL (TOOLBAR) || DETAIL (HANDLEBOX_BIN) || DETAIL (DOCKITEM_BIN)) {
 		// Only draw the shadows on horizontal toolbars
 		if (shadow_type != GTK_SHADOW_NONE && height < 2 * width)
 			equinox_draw_toolbar (cr, colors, NULL, x, y, width, height, equinox_style->toolbarstyle);
-	} else if (DETAIL ("trough")) {
-	} else if (DETAIL ("menu")) {
+	} else if (DETAIL (TROUGH)) {
+	} else if (DETAIL (MENU)) {
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		equinox_draw_menu_frame (cr, colors, &params, x, y, width, height);
 	} else {
 		equinox_parent_class->draw_box (style, window, state_type, shadow_type, area, widget, detail, x, y, width, height);
 	}
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_slider (DRAW_ARGS, GtkOrientation orientation) {
-	if (DETAIL ("hscale") || DETAIL ("vscale"))	{
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_SLIDER);
+	if (DETAIL (HSCALE) || DETAIL (VSCALE))	{
 		EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 		EquinoxColors *colors = &equinox_style->colors;
 		cairo_t *cr;
@@ -850,15 +917,15 @@ static void equinox_style_draw_slider (DRAW_ARGS, GtkOrientation orientation) {
 		WidgetParameters params;
 		SliderParameters slider;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		params.curvature = MIN (MIN(height,width)*0.147, params.curvature);
 		slider.horizontal = TRUE;
-    	slider.horizontal = DETAIL ("hscale");
+    	slider.horizontal = DETAIL (HSCALE);
 
 		if (!params.disabled)
 			equinox_draw_scale_slider (cr, colors, &params, &slider, x, y, width, height, equinox_style->scalesliderstyle);
 
-		cairo_destroy (cr);
+		equinox_end_paint (cr);
 	} else {
 		equinox_parent_class->draw_slider (style, window, state_type, shadow_type,
 				      area, widget, detail, x, y, width,
@@ -867,6 +934,7 @@ static void equinox_style_draw_slider (DRAW_ARGS, GtkOrientation orientation) {
 }
 
 static void equinox_style_draw_option (DRAW_ARGS) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_OPTION);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -876,28 +944,25 @@ static void equinox_style_draw_option (DRAW_ARGS) {
 	SANITIZE_SIZE
 	cr = equinox_begin_paint (window, area);
 
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 	OptionParameters option;
 	option.draw_bullet = ((shadow_type == GTK_SHADOW_IN) || (shadow_type == GTK_SHADOW_ETCHED_IN));
 	option.inconsistent = (shadow_type == GTK_SHADOW_ETCHED_IN);
 
-#ifdef HAVE_ANIMATION
-	if (equinox_style->animation)
-		equinox_animation_connect_checkbox (widget);
+	const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
 
-	if (equinox_style->animation && GTK_IS_CHECK_BUTTON (widget) && equinox_animation_is_animated (widget) && !gtk_toggle_button_get_inconsistent (GTK_TOGGLE_BUTTON (widget)))
-	{
-		gfloat elapsed = equinox_animation_elapsed (widget);
-		params.trans = sqrt (sqrt (MIN(elapsed / CHECK_ANIMATION_TIME, 1.0)));
-	}
-#endif
+	if (hooks)
+		hooks->connect_checkbox (widget);
+
+	if (hooks && GTK_IS_CHECK_BUTTON (widget) && !gtk_toggle_button_get_inconsistent (GTK_TOGGLE_BUTTON (widget)))
+		equinox_apply_animation (hooks, widget, &params, CHECK_ANIMATION_TIME);
 
 	if (widget && EQUINOX_IS_MENU (widget->parent)) {
 		x--;
 		y--;
 		equinox_draw_menu_radiobutton (cr, colors, &params, &option, x, y, width, height);
 	}
-	else if (DETAIL ("cellradio")) {
+	else if (DETAIL (CELLRADIO)) {
 		x--;
 		y--;
 		equinox_draw_cell_radiobutton (cr, colors, &params, &option, x, y, width, height);
@@ -905,10 +970,11 @@ static void equinox_style_draw_option (DRAW_ARGS) {
 	else {
 		equinox_draw_radiobutton (cr, colors, &params, &option, x, y, width, height, equinox_style->checkradiostyle);
 	}
-  cairo_destroy (cr);
+  equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_check (DRAW_ARGS) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_CHECK);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -918,35 +984,33 @@ static void equinox_style_draw_check (DRAW_ARGS) {
 	SANITIZE_SIZE
 	cr = equinox_begin_paint (window, area);
 
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 	OptionParameters option;
 	option.draw_bullet = ((shadow_type == GTK_SHADOW_IN) || (shadow_type == GTK_SHADOW_ETCHED_IN));
 	option.inconsistent = (shadow_type == GTK_SHADOW_ETCHED_IN);
 
-#ifdef HAVE_ANIMATION
-	if (equinox_style->animation)
-		equinox_animation_connect_checkbox (widget);
+	const EquinoxAnimationHooks *hooks = equinox_style->animation_hooks;
 
-	if (equinox_style->animation && GTK_IS_CHECK_BUTTON (widget) && equinox_animation_is_animated (widget) && !gtk_toggle_button_get_inconsistent (GTK_TOGGLE_BUTTON (widget)))
-	{
-		gfloat elapsed = equinox_animation_elapsed (widget);
-		params.trans = sqrt (sqrt (MIN(elapsed / CHECK_ANIMATION_TIME, 1.0)));
-	}
-#endif
+	if (hooks)
+		hooks->connect_checkbox (widget);
+
+	if (hooks && GTK_IS_CHECK_BUTTON (widget) && !gtk_toggle_button_get_inconsistent (GTK_TOGGLE_BUTTON (widget)))
+		equinox_apply_animation (hooks, widget, &params, CHECK_ANIMATION_TIME);
 
 	if (widget && EQUINOX_IS_MENU (widget->parent)) {
 		equinox_draw_menu_checkbutton (cr, colors, &params, &option, x, y, width, height);
 	}
-	else if (DETAIL ("cellcheck")) {
+	else if (DETAIL (CELLCHECK)) {
 		equinox_draw_cell_checkbutton (cr, colors, &params, &option, x, y, width, height);
 	}
 	else {
 		equinox_draw_checkbutton (cr, colors, &params, &option, x, y, width, height, equinox_style->checkradiostyle);
 	}
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_tab (DRAW_ARGS) {
+	equinox_detail_resolve (detail, EQX_ENTRY_TAB);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -957,14 +1021,14 @@ static void equinox_style_draw_tab (DRAW_ARGS) {
 	SANITIZE_SIZE
 	cr = equinox_begin_paint (window, area);
 
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 	arrow.type = EQX_ARROW_NORMAL;
 	arrow.direction = EQX_DIRECTION_DOWN;
 	arrow.size = equinox_style->arrowsize;
 
 	equinox_draw_arrow (cr, colors, &params, &arrow, x, y, width, height);
 
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_vline (GtkStyle * style,
@@ -973,6 +1037,7 @@ static void equinox_style_draw_vline (GtkStyle * style,
 			 GdkRectangle * area,
 			 GtkWidget * widget,
 			 const gchar * detail, gint y1, gint y2, gint x) {
+	equinox_detail_resolve (detail, EQX_ENTRY_VLINE);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr = equinox_begin_paint (window, area);
@@ -985,18 +1050,15 @@ static void equinox_style_draw_vline (GtkStyle * style,
 	} else {
 		separator.inToolbar = FALSE;
 	}
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 
-	if (widget && widget->parent && widget->parent->parent && widget->parent->parent->parent &&
-      EQUINOX_IS_HBOX (widget->parent) &&
-      EQUINOX_IS_TOGGLE_BUTTON (widget->parent->parent) &&
-      EQUINOX_IS_COMBO_BOX (widget->parent->parent->parent)) {
+	if (EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_COMBO_BOX_SEPARATOR)) {
 	}
 	else
 		//equinox_draw_separator (cr, colors, &params, &separator, x, y1, 2, y2 - y1, equinox_style->separatorstyle);
 
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_hline (GtkStyle * style,
@@ -1005,23 +1067,25 @@ static void equinox_style_draw_hline (GtkStyle * style,
 			 GdkRectangle * area,
 			 GtkWidget * widget,
 			 const gchar * detail, gint x1, gint x2, gint y) {
+	equinox_detail_resolve (detail, EQX_ENTRY_HLINE);
 	WidgetParameters params;
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr = equinox_begin_paint (window, area);
 
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 	SeparatorParameters separator;
 	separator.horizontal = TRUE;
 
 	equinox_draw_separator (cr, colors, &params, &separator, x1, y, x2 - x1, 2, equinox_style->separatorstyle);
 
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_shadow_gap (DRAW_ARGS,
 			      GtkPositionType gap_side,
 			      gint gap_x, gint gap_width) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_SHADOW_GAP);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -1030,7 +1094,7 @@ static void equinox_style_draw_shadow_gap (DRAW_ARGS,
 	SANITIZE_SIZE
 	cr = equinox_begin_paint (window, area);
 
-	if (DETAIL ("frame")) {
+	if (DETAIL (FRAME)) {
 		WidgetParameters params;
 		FrameParameters frame;
 
@@ -1042,7 +1106,7 @@ static void equinox_style_draw_shadow_gap (DRAW_ARGS,
 		frame.use_fill = FALSE;
 		frame.fill_bg = TRUE;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		params.curvature = MIN(params.curvature, MIN(params.xthickness, params.ythickness) + 1.5);
 
 		equinox_draw_frame (cr, colors, &params, &frame, x-1, y-1, width+2, height+2);
@@ -1052,7 +1116,7 @@ static void equinox_style_draw_shadow_gap (DRAW_ARGS,
 					  x, y, width, height, gap_side,
 					  gap_x, gap_width);
 	}
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_resize_grip (GtkStyle * style,
@@ -1063,6 +1127,7 @@ static void equinox_style_draw_resize_grip (GtkStyle * style,
 			       const gchar * detail,
 			       GdkWindowEdge edge,
 			       gint x, gint y, gint width, gint height) {
+	equinox_detail_resolve (detail, EQX_ENTRY_RESIZE_GRIP);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
@@ -1074,7 +1139,7 @@ static void equinox_style_draw_resize_grip (GtkStyle * style,
 	WidgetParameters params;
 	ResizeGripParameters grip;
 
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 	grip.edge = (EquinoxWindowEdge) edge;
 
 	/*if (edge != GDK_WINDOW_EDGE_SOUTH_EAST)
@@ -1082,7 +1147,7 @@ static void equinox_style_draw_resize_grip (GtkStyle * style,
 
 	equinox_draw_resize_grip (cr, colors, &params, &grip, x+2*params.xthickness, y+2*params.ythickness, width, height, equinox_style->resizegripstyle);
 
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_draw_arrow (GtkStyle * style,
@@ -1095,29 +1160,30 @@ static void equinox_style_draw_arrow (GtkStyle * style,
 			 GtkArrowType arrow_type,
 			 gboolean fill,
 			 gint x, gint y, gint width, gint height) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_ARROW);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
-	cairo_t *cr = equinox_begin_paint (window, area);
+	cairo_t *cr;
 
 	CHECK_ARGS
 	SANITIZE_SIZE
 
+	cr = equinox_begin_paint (window, area);
+
 	WidgetParameters params;
 	ArrowParameters arrow;
 
-	equinox_set_widget_parameters (widget, style, state_type, &params);
+	equinox_set_widget_parameters (window, widget, style, state_type, &params);
 	arrow.type = EQX_ARROW_NORMAL;
 	params.state_type = (EquinoxStateType) state_type;
 	arrow.direction = (EquinoxDirection) arrow_type;
 
 	if (arrow_type == (GtkArrowType) 4) {
-		cairo_destroy (cr);
+		equinox_end_paint (cr);
 		return;
 	}
 
-	if (widget && widget->parent && widget->parent->parent && widget->parent->parent->parent
-	    && GTK_IS_COMBO_BOX (widget->parent->parent->parent) &&
-	    !(GTK_IS_COMBO_BOX_ENTRY (widget->parent->parent->parent)))
+	if (EQUINOX_WIDGET_HAS_ROLE (widget, EQX_ROLE_COMBO_BOX_BUTTON))
 		x += 1;
 
 	if (arrow.direction == EQX_DIRECTION_RIGHT)
@@ -1125,16 +1191,16 @@ static void equinox_style_draw_arrow (GtkStyle * style,
 	else if (arrow.direction == EQX_DIRECTION_UP)
 		x -= 1;
 
-	if (DETAIL ("arrow")) {
+	if (DETAIL (ARROW)) {
 		arrow.type = EQX_ARROW_COMBO;
-	} else if ((DETAIL ("hscrollbar") || DETAIL ("vscrollbar"))) {
+	} else if ((DETAIL (HSCROLLBAR) || DETAIL (VSCROLLBAR))) {
 		arrow.type = EQX_ARROW_SCROLL;
-		if (DETAIL ("vscrollbar")) {
+		if (DETAIL (VSCROLLBAR)) {
 			x++;
 			width++;
 		} else
 			height++;
-	} else if (DETAIL ("spinbutton")) {
+	} else if (DETAIL (SPINBUTTON)) {
 		arrow.type = EQX_ARROW_SPINBUTTON;
 		x += 2;
 		if (arrow.direction == EQX_DIRECTION_UP)
@@ -1143,7 +1209,7 @@ static void equinox_style_draw_arrow (GtkStyle * style,
 
 	equinox_draw_arrow (cr, colors, &params, &arrow, x, y, width, height);
 
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_init_from_rc (GtkStyle * style, GtkRcStyle * rc_style) {
@@ -1176,6 +1242,10 @@ static void equinox_style_init_from_rc (GtkStyle * style, GtkRcStyle * rc_style)
 	equinox_style->textstyle = EQUINOX_RC_STYLE (rc_style)->textstyle;
 	equinox_style->textshade = EQUINOX_RC_STYLE (rc_style)->textshade;
 	equinox_style->animation = EQUINOX_RC_STYLE (rc_style)->animation;
+	equinox_style->animation_hooks = equinox_animation_get_hooks (equinox_style->animation);
+	if (equinox_style->animation_hooks)
+		equinox_style->animation_hooks->set_limits (EQUINOX_RC_STYLE (rc_style)->animationlimit,
+		                                            EQUINOX_RC_STYLE (rc_style)->animationbudget);
 	equinox_style->arrowsize = EQUINOX_RC_STYLE (rc_style)->arrowsize;
 }
 
@@ -1216,42 +1286,49 @@ static void equinox_style_realize (GtkStyle * style) {
 		equinox_gdk_color_to_cairo (&style->text[i], &equinox_style->colors.text[i]);
 		equinox_gdk_color_to_cairo (&style->fg[i], &equinox_style->colors.fg[i]);
 	}
+
+	equinox_style->colors.fingerprint = equinox_cache_palette_fingerprint (&equinox_style->colors);
+	equinox_derive_colors (&equinox_style->colors, equinox_style->buttonstyle);
+
+	/* New styles usually mean new widgets; give late registered types a chance */
+	equinox_types_rescan ();
 }
 
 static void equinox_style_draw_focus (GtkStyle * style, GdkWindow * window,
 			 GtkStateType state_type, GdkRectangle * area,
 			 GtkWidget * widget, const gchar * detail, gint x,
 			 gint y, gint width, gint height) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_FOCUS);
 	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 	EquinoxColors *colors = &equinox_style->colors;
 	cairo_t *cr;
 
 	CHECK_ARGS
 	SANITIZE_SIZE
-	cr = gdk_cairo_create (window);
+	cr = equinox_begin_paint (window, area);
 
 	//As all other focus drawing is taken care of by respective widgets...
 	//GtkTextView
 
-	if (DETAIL ("scrolled_window") || DETAIL ("viewport") || detail == NULL
-				|| (DETAIL ("button") && widget && (EQUINOX_IS_TREE_VIEW (widget->parent) || EQUINOX_IS_CLIST (widget->parent)))) {
+	if (DETAIL (SCROLLED_WINDOW) || DETAIL (VIEWPORT) || detail == NULL
+				|| (DETAIL (BUTTON) && widget && (EQUINOX_IS_TREE_VIEW (widget->parent) || EQUINOX_IS_CLIST (widget->parent)))) {
 
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		EquinoxRGB focus_color = colors->spot[1];
 
 		cairo_set_line_width (cr, 1.0);
 		cairo_set_source_rgba (cr, colors->spot[1].r, colors->spot[1].g, colors->spot[1].b, 0.10);
 		clearlooks_rounded_rectangle (cr, x, y, width, height, params.curvature, EQX_CORNER_ALL);
 		cairo_fill (cr);
-		cairo_rectangle (cr, x+0.5, y+0.5, width-1, height - (DETAIL ("button") ? 2 : 1));
+		cairo_rectangle (cr, x+0.5, y+0.5, width-1, height - (DETAIL (BUTTON) ? 2 : 1));
 		equinox_set_source_rgba (cr, &colors->spot[1], 0.75);
 		cairo_stroke (cr);
-	} else if ((DETAIL ("checkbutton") || DETAIL ("expander") || (DETAIL ("trough") && widget && GTK_IS_SCALE (widget))) || (detail && g_str_has_prefix (detail, "treeview"))) {
+	} else if ((DETAIL (CHECKBUTTON) || DETAIL (EXPANDER) || (DETAIL (TROUGH) && widget && GTK_IS_SCALE (widget))) || DETAIL (TREEVIEW)) {
 		WidgetParameters params;
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 		double roundness;
-		if (detail && g_str_has_prefix (detail, "treeview")) {
+		if DETAIL (TREEVIEW) {
 			roundness = 0;
 		} else {
 			roundness = params.curvature;
@@ -1269,7 +1346,7 @@ static void equinox_style_draw_focus (GtkStyle * style, GdkWindow * window,
 		cairo_stroke (cr);
 	}
 
-	cairo_destroy (cr);
+	equinox_end_paint (cr);
 }
 
 static void equinox_style_copy (GtkStyle * style, GtkStyle * src) {
@@ -1301,6 +1378,7 @@ static void equinox_style_copy (GtkStyle * style, GtkStyle * src) {
 	eqx_style->textshade = eqx_src->textshade;
 	eqx_style->arrowsize = eqx_src->arrowsize;
 	eqx_style->animation = eqx_src->animation;
+	eqx_style->animation_hooks = eqx_src->animation_hooks;
 
 	equinox_parent_class->copy (style, src);
 }
@@ -1493,6 +1571,7 @@ static void equinox_style_draw_layout (GtkStyle * style,
 	     GdkRectangle * area,
 	     GtkWidget * widget,
 	     const gchar * detail, gint x, gint y, PangoLayout *layout) {
+	EquinoxDetail eqx_detail = equinox_detail_resolve (detail, EQX_ENTRY_LAYOUT);
 	GdkGC *gc;
 
 	g_return_if_fail (GTK_IS_STYLE (style));
@@ -1506,14 +1585,14 @@ static void equinox_style_draw_layout (GtkStyle * style,
 	if (widget && (state_type == GTK_STATE_INSENSITIVE ||
 	    (EQUINOX_STYLE (style)->textstyle != 0 &&
 	     state_type != GTK_STATE_PRELIGHT &&
-	     !(DETAIL ("cellrenderertext") && state_type == GTK_STATE_NORMAL))))
+	     !(DETAIL (CELLRENDERERTEXT) && state_type == GTK_STATE_NORMAL))))
 	{
 		EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 		EquinoxColors *colors = &equinox_style->colors;
 
 		WidgetParameters params;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 		GdkColor etched;
 		EquinoxRGB temp;
@@ -1547,39 +1626,29 @@ static void equinox_style_draw_layout (GtkStyle * style,
 
 		if (!gtk_widget_get_has_window (widget)) {
 			boolean use_parentbg = TRUE;
-			while (widget->parent) {
-				if (EQUINOX_IS_BUTTON(widget->parent) ||
-				    EQUINOX_IS_TOGGLE_BUTTON(widget->parent) ||
-				    EQUINOX_IS_COMBO_BOX(widget->parent) ||
-				    EQUINOX_IS_COMBO_BOX_ENTRY(widget->parent) ||
-				    EQUINOX_IS_COMBO(widget->parent) ||
-				    EQUINOX_IS_OPTION_MENU(widget->parent) ||
-				    EQUINOX_IS_NOTEBOOK(widget->parent)) {
-					GtkReliefStyle relief = GTK_RELIEF_NORMAL;
-					// Check for the shadow type.make
-					if (EQUINOX_IS_BUTTON (widget->parent))
-						g_object_get (G_OBJECT (widget->parent), "relief", &relief, NULL);
-
-					if (!EQUINOX_IS_CHECK_BUTTON(widget->parent) &&
-					    !EQUINOX_IS_RADIO_BUTTON(widget->parent) &&
-					    !(relief == GTK_RELIEF_NONE &&
-					      (state_type == GTK_STATE_NORMAL ||
-					       state_type == GTK_STATE_INSENSITIVE)))
-						use_parentbg = FALSE;
-
-					break;
-				}
-				widget = widget->parent;
+			GtkWidget *button = equinox_widget_get_roles (widget)->button_parent;
+			if (button) {
+				GtkReliefStyle relief = GTK_RELIEF_NORMAL;
+				// Check for the shadow type.make
+				if (EQUINOX_IS_BUTTON (button))
+					g_object_get (G_OBJECT (button), "relief", &relief, NULL);
+
+				if (!EQUINOX_IS_CHECK_BUTTON(button) &&
+				    !EQUINOX_IS_RADIO_BUTTON(button) &&
+				    !(relief == GTK_RELIEF_NONE &&
+				      (state_type == GTK_STATE_NORMAL ||
+				       state_type == GTK_STATE_INSENSITIVE)))
+					use_parentbg = FALSE;
 			}
 
 			if (use_parentbg)
-				murrine_shade (&params.parentbg, shade_level, &temp);
-			else if (DETAIL ("cellrenderertext"))
+				murrine_shade (equinox_params_parentbg (&params), shade_level, &temp);
+			else if (DETAIL (CELLRENDERERTEXT))
 				murrine_shade (&colors->base[state_type], shade_level, &temp);
 			else
 				murrine_shade (&colors->bg[state_type], shade_level, &temp);
 		}
-		else if (DETAIL ("cellrenderertext"))
+		else if (DETAIL (CELLRENDERERTEXT))
 			//murrine_shade (&colors->base[state_type], shade_level, &temp);
 			murrine_shade (&colors->base[GTK_STATE_NORMAL], shade_level - 0.12, &temp);
 		else
@@ -1596,21 +1665,21 @@ static void equinox_style_draw_layout (GtkStyle * style,
 		pango_cairo_layout_path (cr, layout);
 		equinox_set_source_rgba (cr, &temp, 0.5);
 		cairo_stroke (cr);
-		cairo_destroy (cr);
+		equinox_end_paint (cr);
 	}
 
-	if (DETAIL ("accellabel")) {
+	if (DETAIL (ACCELLABEL)) {
 		EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
 		EquinoxColors *colors = &equinox_style->colors;
 
 		WidgetParameters params;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 		GdkColor etched;
 		EquinoxRGB temp;
 
-		equinox_mix_color (&colors->fg[state_type], &params.parentbg, state_type != GTK_STATE_PRELIGHT ? 0.4 : 0.2, &temp);
+		equinox_mix_color (&colors->fg[state_type], equinox_params_parentbg (&params), state_type != GTK_STATE_PRELIGHT ? 0.4 : 0.2, &temp);
 
 		etched.red = (int) (temp.r*65535);
 		etched.green = (int) (temp.g*65535);
@@ -1629,15 +1698,15 @@ static void equinox_style_draw_layout (GtkStyle * style,
 		GdkColor etched;
 		EquinoxRGB temp;
 
-		equinox_set_widget_parameters (widget, style, state_type, &params);
+		equinox_set_widget_parameters (window, widget, style, state_type, &params);
 
 		double bg_value, text_value;
-		bg_value = MAX (MAX (params.parentbg.r, params.parentbg.g), params.parentbg.b);
+		bg_value = MAX (MAX (equinox_params_parentbg (&params)->r, equinox_params_parentbg (&params)->g), equinox_params_parentbg (&params)->b);
 		text_value = MAX (MAX (colors->text[widget->state].r, colors->text[widget->state].g), colors->text[widget->state].b);
 
 		if(text_value < (bg_value + 0.1*bg_value) ) {
 		    if (widget && GTK_WIDGET_NO_WINDOW (widget))
-		      equinox_shade (&params.parentbg, &temp, 1.15);
+		      equinox_shade (equinox_params_parentbg (&params), &temp, 1.15);
 		    else
 		      equinox_shade (&colors->bg[widget->state], &temp, 1.15);
 
@@ -1656,6 +1725,126 @@ static void equinox_style_draw_layout (GtkStyle * style,
     	gdk_gc_set_clip_rectangle (gc, NULL);
 }
 
+//#define DEFAULT_EXPANDER_SIZE 11
+#define DEFAULT_EXPANDER_SIZE 7
+
+/* The expander has a fixed size and line width, and it is always drawn at
+ * integer coordinates, so its offset from x, y only depends on the expander
+ * style.  Work it out once per style. */
+static void equinox_expander_geometry (GtkExpanderStyle expander_style, double *x_offset, double *y_offset, double *radius) {
+	static gboolean initialized = FALSE;
+	static double offsets[GTK_EXPANDER_EXPANDED + 1][2];
+	static double expander_radius;
+
+	if (!initialized) {
+		gint expander_size;
+		gint line_width;
+		double vertical_overshoot;
+		int diameter;
+		double x_double_horz, y_double_horz;
+		double x_double_vert, y_double_vert;
+		int i;
+
+		/*if (widget &&
+		  gtk_widget_class_find_style_property (GTK_WIDGET_GET_CLASS (widget),
+							"expander-size")) {
+		gtk_widget_style_get (widget, "expander-size", &expander_size, NULL);
+		}
+		else*/
+		expander_size = DEFAULT_EXPANDER_SIZE;
+
+		line_width = 1;
+
+		/* Compute distance that the stroke extends beyonds the end
+		* of the triangle we draw.
+		*/
+		vertical_overshoot = line_width / 2.0 * (1. / tan (G_PI / 8));
+
+		/* For odd line widths, we end the vertical line of the triangle
+		* at a half pixel, so we round differently.
+		*/
+		if (line_width % 2 == 1)
+			vertical_overshoot = ceil (0.5 + vertical_overshoot) - 0.5;
+		else
+			vertical_overshoot = ceil (vertical_overshoot);
+
+		/* Adjust the size of the triangle we draw so that the entire stroke fits
+		*/
+		diameter = MAX (3, expander_size - 2 * vertical_overshoot);
+
+		/* If the line width is odd, we want the diameter to be even,
+		* and vice versa, so force the sum to be odd. This relationship
+		* makes the point of the triangle look right.
+		*/
+		diameter -= (1 - (diameter + line_width) % 2);
+
+		expander_radius = diameter / 2. + 4;
+
+		/* Adjust the center so that the stroke is properly aligned with
+		* the pixel grid. The center adjustment is different for the
+		* horizontal and vertical orientations. For intermediate positions
+		* we interpolate between the two.  Computed at the origin; for
+		* integer x and y everything just shifts along.
+		*/
+		x_double_vert = floor (- (expander_radius + line_width) / 2.) + (expander_radius + line_width) / 2. + ceil (expander_radius / 8.0);
+		y_double_vert = - 0.5;
+
+		x_double_horz = - 0.5 + ceil (expander_radius / 8.0);
+		y_double_horz = floor (- (expander_radius + line_width) / 2.) + (expander_radius + line_width) / 2.;
+
+		for (i = 0; i <= GTK_EXPANDER_EXPANDED; i++) {
+			double interp;	/* interpolation factor for center position */
+
+			switch (i) {
+				case GTK_EXPANDER_COLLAPSED:
+					interp = 0.0;
+					break;
+				case GTK_EXPANDER_SEMI_COLLAPSED:
+					interp = 0.25;
+					break;
+				case GTK_EXPANDER_SEMI_EXPANDED:
+					interp = 0.75;
+					break;
+				default:
+					interp = 1.0;
+					break;
+			}
+
+			offsets[i][0] = x_double_vert * (1 - interp) + x_double_horz * interp;
+			offsets[i][1] = y_double_vert * (1 - interp) + y_double_horz * interp;
+		}
+
+		initialized = TRUE;
+	}
+
+	*x_offset = offsets[expander_style][0];
+	*y_offset = offsets[expander_style][1];
+	*radius = expander_radius;
+}
+
+static void equinox_draw_expander_glyph (cairo_t *cr, double x, double y, double radius, gint degrees,
+			    const EquinoxRGB *fill, const EquinoxRGB *stroke) {
+	cairo_save (cr);
+
+	cairo_translate (cr, x, y);
+	cairo_rotate (cr, degrees * G_PI / 180);
+
+	cairo_move_to (cr, -radius / 2., -radius / 2.0);
+	cairo_line_to (cr,  radius / 2.,  0);
+	cairo_line_to (cr, -radius / 2.,  radius / 2.0);
+	cairo_close_path (cr);
+
+	cairo_set_line_width (cr, 1);
+
+	equinox_set_source_rgb (cr, fill);
+	cairo_fill_preserve (cr);
+
+	equinox_set_source_rgb (cr, stroke);
+	cairo_stroke (cr);
+
+	cairo_restore (cr);
+}
+
 static void equinox_style_draw_expander (GtkStyle * style,
 			    GdkWindow * window,
 			    GtkStateType state_type,
@@ -1663,123 +1852,66 @@ static void equinox_style_draw_expander (GtkStyle * style,
 			    GtkWidget * widget,
 			    const gchar * detail,
 			    gint x, gint y, GtkExpanderStyle expander_style) {
-//#define DEFAULT_EXPANDER_SIZE 11
-#define DEFAULT_EXPANDER_SIZE 7
-
-	gint expander_size;
-	gint line_width;
-	double vertical_overshoot;
-	int diameter;
-	double radius;
-	double interp;		/* interpolation factor for center position */
-	double x_double_horz, y_double_horz;
-	double x_double_vert, y_double_vert;
-	double x_double, y_double;
+	EquinoxStyle *equinox_style = EQUINOX_STYLE (style);
+	EquinoxAtlasKey key;
+	EquinoxAtlasSprite sprite;
+	EquinoxRGB fill, stroke;
+	double x_offset, y_offset, radius;
 	gint degrees = 0;
+	cairo_t *atlas_cr;
 
-	cairo_t *cr = gdk_cairo_create (window);
-
-	if (area) {
-		gdk_cairo_rectangle (cr, area);
-		cairo_clip (cr);
-	}
-
-	/*if (widget &&
-	  gtk_widget_class_find_style_property (GTK_WIDGET_GET_CLASS (widget),
-						"expander-size")) {
-	gtk_widget_style_get (widget, "expander-size", &expander_size, NULL);
-	}
-	else*/
-	expander_size = DEFAULT_EXPANDER_SIZE;
-
-	line_width = 1;
+	cairo_t *cr = equinox_begin_paint (window, area);
 
 	switch (expander_style) {
 		case GTK_EXPANDER_COLLAPSED:
 			degrees = (equinox_get_direction (widget) == GTK_TEXT_DIR_RTL) ? 180 : 0;
-			interp = 0.0;
 			break;
 		case GTK_EXPANDER_SEMI_COLLAPSED:
 			degrees = (equinox_get_direction (widget) == GTK_TEXT_DIR_RTL) ? 150 : 30;
-			interp = 0.25;
 			break;
 		case GTK_EXPANDER_SEMI_EXPANDED:
 			degrees = (equinox_get_direction (widget) == GTK_TEXT_DIR_RTL) ? 120 : 60;
-			interp = 0.75;
 			break;
 		case GTK_EXPANDER_EXPANDED:
 			degrees = 90;
-			interp = 1.0;
 			break;
 		default:
 			g_assert_not_reached ();
 	}
 
-	/* Compute distance that the stroke extends beyonds the end
-	* of the triangle we draw.
-	*/
-	vertical_overshoot = line_width / 2.0 * (1. / tan (G_PI / 8));
-
-	/* For odd line widths, we end the vertical line of the triangle
-	* at a half pixel, so we round differently.
-	*/
-	if (line_width % 2 == 1)
-		vertical_overshoot = ceil (0.5 + vertical_overshoot) - 0.5;
-	else
-		vertical_overshoot = ceil (vertical_overshoot);
-
-	/* Adjust the size of the triangle we draw so that the entire stroke fits
-	*/
-	diameter = MAX (3, expander_size - 2 * vertical_overshoot);
-
-	/* If the line width is odd, we want the diameter to be even,
-	* and vice versa, so force the sum to be odd. This relationship
-	* makes the point of the triangle look right.
-	*/
-	diameter -= (1 - (diameter + line_width) % 2);
-
-	radius = diameter / 2. + 4;
-
-	/* Adjust the center so that the stroke is properly aligned with
-	* the pixel grid. The center adjustment is different for the
-	* horizontal and vertical orientations. For intermediate positions
-	* we interpolate between the two.
-	*/
-	x_double_vert = floor (x - (radius + line_width) / 2.) + (radius + line_width) / 2. + ceil (radius / 8.0);
-	y_double_vert = y - 0.5;
-
-	x_double_horz = x - 0.5 + ceil (radius / 8.0);
-	y_double_horz = floor (y - (radius + line_width) / 2.) + (radius + line_width) / 2.;
-
-	x_double = x_double_vert * (1 - interp) + x_double_horz * interp;
-	y_double = y_double_vert * (1 - interp) + y_double_horz * interp;
-
-	cairo_translate (cr, x_double, y_double);
-	cairo_rotate (cr, degrees * G_PI / 180);
-
-	cairo_move_to (cr, -radius / 2., -radius / 2.0);
-	cairo_line_to (cr,  radius / 2.,  0);
-	cairo_line_to (cr, -radius / 2.,  radius / 2.0);
-	cairo_close_path (cr);
-
-	cairo_set_line_width (cr, line_width);
+	equinox_expander_geometry (expander_style, &x_offset, &y_offset, &radius);
 
 	if (state_type == GTK_STATE_INSENSITIVE)
-		gdk_cairo_set_source_color (cr, &style->base[GTK_STATE_INSENSITIVE]);
+		equinox_gdk_color_to_cairo (&style->base[GTK_STATE_INSENSITIVE], &fill);
 	else if (state_type == GTK_STATE_PRELIGHT)
-		gdk_cairo_set_source_color (cr, &style->base[GTK_STATE_NORMAL]);
+		equinox_gdk_color_to_cairo (&style->base[GTK_STATE_NORMAL], &fill);
 	else if (state_type == GTK_STATE_ACTIVE)
-		gdk_cairo_set_source_color (cr, &style->light[GTK_STATE_ACTIVE]);
+		equinox_gdk_color_to_cairo (&style->light[GTK_STATE_ACTIVE], &fill);
 	else
-		gdk_cairo_set_source_color (cr, &style->fg[GTK_STATE_PRELIGHT]);
+		equinox_gdk_color_to_cairo (&style->fg[GTK_STATE_PRELIGHT], &fill);
 
-	cairo_fill_preserve (cr);
+	equinox_gdk_color_to_cairo (&style->fg[state_type], &stroke);
 
-	gdk_cairo_set_source_color (cr, &style->fg[state_type]);
-	cairo_stroke (cr);
+	if (!equinox_atlas_key_init (&key, EQX_ATLAS_EXPANDER, &equinox_style->colors, state_type, 0)) {
+		equinox_draw_expander_glyph (cr, x + x_offset, y + y_offset, radius, degrees, &fill, &stroke);
+		equinox_end_paint (cr);
+		return;
+	}
+
+	key.direction = degrees / 30;
+	key.variant = expander_style;
+	key.color = fill;
+	key.color2 = stroke;
+
+	if (!equinox_atlas_lookup (&key, &sprite)) {
+		atlas_cr = equinox_atlas_begin_render (&key, &sprite);
+		equinox_draw_expander_glyph (atlas_cr, sprite.x + x_offset, sprite.y + y_offset, radius, degrees, &fill, &stroke);
+		cairo_destroy (atlas_cr);
+	}
 
-	cairo_destroy (cr);
+	equinox_atlas_blit (cr, &sprite, x, y);
 
+	equinox_end_paint (cr);
 }
 
 
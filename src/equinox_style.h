@@ -72,6 +72,7 @@ struct _EquinoxStyle
 	guint8 textstyle;
 	double textshade;
 	gboolean animation;
+	const EquinoxAnimationHooks *animation_hooks;	/* NULL if animation is off */
 	gdouble arrowsize;
 
 };
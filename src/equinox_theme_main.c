@@ -3,6 +3,23 @@
 
 #include "equinox_style.h"
 #include "equinox_rc_style.h"
+#include "equinox_cache.h"
+#include "equinox_detail.h"
+#include "equinox_frame.h"
+#include "support.h"
+#include "animation.h"
+
+/* Set EQUINOX_STATS in the environment to get the engine's counters
+ * printed when the module is unloaded. */
+static void equinox_print_stats (void) {
+	equinox_cache_print_stats ();
+	equinox_detail_print_stats ();
+	equinox_parent_bg_print_stats ();
+	equinox_params_print_stats ();
+	equinox_cull_print_stats ();
+	equinox_animation_print_stats ();
+	equinox_frame_print_stats ();
+}
 
 G_MODULE_EXPORT void theme_init (GTypeModule *module) {
 	equinox_rc_style_register_type (module);
@@ -10,6 +27,11 @@ G_MODULE_EXPORT void theme_init (GTypeModule *module) {
 }
 
 G_MODULE_EXPORT void theme_exit (void) {
+	if (g_getenv ("EQUINOX_STATS"))
+		equinox_print_stats ();
+
+	equinox_frame_cleanup ();
+	equinox_cache_cleanup ();
 }
 
 G_MODULE_EXPORT GtkRcStyle *theme_create_rc_style (void) {
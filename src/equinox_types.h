@@ -124,6 +124,43 @@ typedef struct {
 	double height;
 } EquinoxRectangle;
 
+/* Button colours for one state/variant, see equinox_button_colors */
+typedef struct {
+	EquinoxRGB fill;
+	EquinoxRGB fill_darker;
+	EquinoxRGB mid_highlight;
+	EquinoxRGB highlight;
+	EquinoxRGB edge_highlight;
+	EquinoxRGB border;
+	EquinoxRGB shadow;
+} EquinoxButtonColors;
+
+/* normal, pressed, pressed + prelight; the same again when disabled */
+#define EQX_BUTTON_VARIANTS 6
+#define EQX_BUTTON_VARIANT(active, prelight, disabled) \
+	(((disabled) ? 3 : 0) + ((active) ? ((prelight) ? 2 : 1) : 0))
+
+/* Colours the draw functions derive from the palette.  They only depend on
+ * the style, so they are built once in equinox_style_realize instead of on
+ * every draw call. */
+typedef struct {
+	double bg_lightness;
+	double prelight_lightness;
+	double spot_lightness;
+
+	int buttonstyle;
+	EquinoxButtonColors button[5][EQX_BUTTON_VARIANTS];
+
+	EquinoxRGB header_sorted_prelight;
+
+	EquinoxRGB spot_darker;
+	EquinoxRGB spot_lighter;
+	EquinoxRGB spot_stripe;
+	EquinoxRGB spot_highlight;
+	EquinoxRGB spot_border_darker;
+	EquinoxRGB spot_border_lighter[2];	/* on dark / light parents */
+} EquinoxDerivedColors;
+
 typedef struct {
 	EquinoxRGB bg[5];
 	EquinoxRGB base[5];
@@ -137,8 +174,24 @@ typedef struct {
 
 	EquinoxRGB spot[3];
 
+	/* Hash of the colours above, keys the surface cache; 0 = unset */
+	unsigned int fingerprint;
+
+	EquinoxDerivedColors derived;
 } EquinoxColors;
 
+typedef enum {
+	EQX_PARAM_PARENTBG = 1 << 0,
+	EQX_PARAM_LTR      = 1 << 1
+} EquinoxLazyParam;
+
+typedef struct {
+	const void *source;	/* the GtkWidget, may be NULL */
+	uint8 pending;		/* EquinoxLazyParam bits not evaluated yet */
+	EquinoxRGB parentbg;
+	boolean ltr;
+} EquinoxLazyParams;
+
 typedef struct {
 	boolean active;
 	boolean prelight;
@@ -149,11 +202,9 @@ typedef struct {
 	uint8 corners;
 	uint8 xthickness;
 	uint8 ythickness;
-	EquinoxRGB parentbg;
 
 	EquinoxStateType prev_state_type;
 	double trans;
-	boolean ltr;
 	//boolean composited;
 
 	// Style
@@ -170,6 +221,11 @@ typedef struct {
 	MurrineGradients mrn_gradient;
 	MurrineStyles style;*/
 
+	/* Evaluated on first use, read them through equinox_params_parentbg
+	 * and equinox_params_ltr.  lazy points at own_lazy, or at the frame
+	 * memo's copy so later calls in the same expose see the results. */
+	EquinoxLazyParams *lazy;
+	EquinoxLazyParams own_lazy;
 } WidgetParameters;
 
 typedef struct {
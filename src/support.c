@@ -1,4 +1,5 @@
 #include "support.h"
+#include "equinox_detail.h"
 
 G_GNUC_INTERNAL void
 equinox_rgb_to_hls (gdouble *r,
@@ -171,21 +172,116 @@ equinox_get_direction (GtkWidget *widget)
 
    Based on/modified from functions in
    Smooth-Engine.
+
+   The GTypes are looked up by name the first time they are needed and kept
+   in equinox_types.  Types that do not exist yet (optional libraries such as
+   Bonobo or the panel, or GTK+ classes nobody instantiated so far) are
+   looked up again every EQX_GTYPE_RETRY checks, or on the next
+   equinox_types_rescan, so plugins loaded after the theme are picked up.
 */
-gboolean
-equinox_object_is_a (const GObject * object, const gchar * type_name)
+#define EQX_GTYPE_RETRY 256
+
+static const gchar *equinox_type_names[EQX_GTYPE_LAST] = {
+	[EQX_GTYPE_WIDGET] = "GtkWidget",
+	[EQX_GTYPE_CONTAINER] = "GtkContainer",
+	[EQX_GTYPE_BIN] = "GtkBin",
+	[EQX_GTYPE_ARROW] = "GtkArrow",
+	[EQX_GTYPE_SEPARATOR] = "GtkSeparator",
+	[EQX_GTYPE_VSEPARATOR] = "GtkVSeparator",
+	[EQX_GTYPE_HSEPARATOR] = "GtkHSeparator",
+	[EQX_GTYPE_HANDLE_BOX] = "GtkHandleBox",
+	[EQX_GTYPE_BONOBO_DOCK_ITEM] = "BonoboDockItem",
+	[EQX_GTYPE_BONOBO_DOCK_ITEM_GRIP] = "BonoboDockItemGrip",
+	[EQX_GTYPE_BONOBO_UI_TOOLBAR] = "BonoboUIToolbar",
+	[EQX_GTYPE_EGG_TOOLBAR] = "Toolbar",
+	[EQX_GTYPE_TOOLBAR] = "GtkToolbar",
+	[EQX_GTYPE_PANEL_WIDGET] = "PanelWidget",
+	[EQX_GTYPE_PANEL_APPLET] = "PanelApplet",
+	[EQX_GTYPE_WINDOW] = "GtkWindow",
+	[EQX_GTYPE_COMBO_BOX_ENTRY] = "GtkComboBoxEntry",
+	[EQX_GTYPE_COMBO_BOX] = "GtkComboBox",
+	[EQX_GTYPE_COMBO] = "GtkCombo",
+	[EQX_GTYPE_OPTION_MENU] = "GtkOptionMenu",
+	[EQX_GTYPE_TOGGLE_BUTTON] = "GtkToggleButton",
+	[EQX_GTYPE_CHECK_BUTTON] = "GtkCheckButton",
+	[EQX_GTYPE_RADIO_BUTTON] = "GtkRadioButton",
+	[EQX_GTYPE_SPIN_BUTTON] = "GtkSpinButton",
+	[EQX_GTYPE_STATUSBAR] = "GtkStatusbar",
+	[EQX_GTYPE_PROGRESS_BAR] = "GtkProgressBar",
+	[EQX_GTYPE_MENU_SHELL] = "GtkMenuShell",
+	[EQX_GTYPE_MENU] = "GtkMenu",
+	[EQX_GTYPE_MENU_BAR] = "GtkMenuBar",
+	[EQX_GTYPE_MENU_ITEM] = "GtkMenuItem",
+	[EQX_GTYPE_CHECK_MENU_ITEM] = "GtkCheckMenuItem",
+	[EQX_GTYPE_RANGE] = "GtkRange",
+	[EQX_GTYPE_SCROLLBAR] = "GtkScrollbar",
+	[EQX_GTYPE_VSCROLLBAR] = "GtkVScrollbar",
+	[EQX_GTYPE_HSCROLLBAR] = "GtkHScrollbar",
+	[EQX_GTYPE_SCALE] = "GtkScale",
+	[EQX_GTYPE_VSCALE] = "GtkVScale",
+	[EQX_GTYPE_HSCALE] = "GtkHScale",
+	[EQX_GTYPE_PANED] = "GtkPaned",
+	[EQX_GTYPE_VPANED] = "GtkVPaned",
+	[EQX_GTYPE_HPANED] = "GtkHPaned",
+	[EQX_GTYPE_BOX] = "GtkBox",
+	[EQX_GTYPE_VBOX] = "GtkVBox",
+	[EQX_GTYPE_HBOX] = "GtkHBox",
+	[EQX_GTYPE_CLIST] = "GtkCList",
+	[EQX_GTYPE_TREE_VIEW] = "GtkTreeView",
+	[EQX_GTYPE_ENTRY] = "GtkEntry",
+	[EQX_GTYPE_BUTTON] = "GtkButton",
+	[EQX_GTYPE_FIXED] = "GtkFixed",
+	[EQX_GTYPE_VIEWPORT] = "GtkViewport",
+	[EQX_GTYPE_SCROLLED_WINDOW] = "GtkScrolledWindow",
+	[EQX_GTYPE_NOTEBOOK] = "GtkNotebook",
+	[EQX_GTYPE_CELL_RENDERER_TOGGLE] = "GtkCellRendererToggle",
+	[EQX_GTYPE_COLOR_BUTTON] = "GtkColorButton",
+	[EQX_GTYPE_EVENT_BOX] = "GtkEventBox",
+	[EQX_GTYPE_ETREE] = "ETree",
+	[EQX_GTYPE_ETABLE] = "ETable",
+};
+
+static GType equinox_types[EQX_GTYPE_LAST];
+static guint16 equinox_types_retry[EQX_GTYPE_LAST];
+
+static inline GType
+equinox_type_lookup (EquinoxTypeId type_id)
 {
-  gboolean result = FALSE;
+  GType type = equinox_types[type_id];
 
-  if ((object))
-    {
-      GType tmp = g_type_from_name (type_name);
+  if (G_LIKELY (type))
+    return type;
 
-      if (tmp)
-	result = g_type_check_instance_is_a ((GTypeInstance *) object, tmp);
+  if (equinox_types_retry[type_id] > 0)
+    {
+      equinox_types_retry[type_id]--;
+      return 0;
     }
 
-  return result;
+  type = g_type_from_name (equinox_type_names[type_id]);
+  equinox_types[type_id] = type;
+  equinox_types_retry[type_id] = EQX_GTYPE_RETRY;
+
+  return type;
+}
+
+void
+equinox_types_rescan (void)
+{
+  memset (equinox_types_retry, 0, sizeof (equinox_types_retry));
+}
+
+gboolean
+equinox_object_is_type (const GObject * object, EquinoxTypeId type_id)
+{
+  GType type;
+
+  if (!object)
+    return FALSE;
+
+  type = equinox_type_lookup (type_id);
+
+  return type && g_type_check_instance_is_a ((GTypeInstance *) object, type);
 }
 
 
@@ -343,6 +439,133 @@ equinox_is_bonobo_dock_item (GtkWidget * widget)
   return result;
 }
 
+/* Widget roles
+
+   The checks above walk all the way up the widget tree.  They are run for
+   every expose of every widget, so the results are kept in qdata on the
+   widget and only recomputed after it was moved in the hierarchy.
+*/
+static GQuark equinox_roles_quark = 0;
+
+static const EquinoxWidgetRoles no_roles = { TRUE, 0, NULL };
+
+static void
+equinox_widget_roles_invalidate (GtkWidget * widget, gpointer unused, EquinoxWidgetRoles * roles)
+{
+  roles->valid = FALSE;
+}
+
+static GtkWidget *
+equinox_find_button_parent (GtkWidget * widget)
+{
+  while (widget->parent)
+    {
+      if (EQUINOX_IS_BUTTON (widget->parent) ||
+          EQUINOX_IS_TOGGLE_BUTTON (widget->parent) ||
+          EQUINOX_IS_COMBO_BOX (widget->parent) ||
+          EQUINOX_IS_COMBO_BOX_ENTRY (widget->parent) ||
+          EQUINOX_IS_COMBO (widget->parent) ||
+          EQUINOX_IS_OPTION_MENU (widget->parent) ||
+          EQUINOX_IS_NOTEBOOK (widget->parent))
+        return widget->parent;
+      widget = widget->parent;
+    }
+
+  return NULL;
+}
+
+static void
+equinox_widget_roles_compute (GtkWidget * widget, EquinoxWidgetRoles * roles)
+{
+  GtkWidget *parent = widget->parent;
+  GtkWidget *grandparent = parent ? parent->parent : NULL;
+  GtkWidget *ancestor;
+  guint32 result = 0;
+
+  for (ancestor = parent; ancestor; ancestor = ancestor->parent)
+    {
+      if (!(result & EQX_ROLE_TOOLBAR_ITEM) &&
+          (EQUINOX_IS_BONOBO_TOOLBAR (ancestor) ||
+           EQUINOX_IS_BONOBO_DOCK_ITEM (ancestor) ||
+           EQUINOX_IS_EGG_TOOLBAR (ancestor) ||
+           EQUINOX_IS_TOOLBAR (ancestor) ||
+           EQUINOX_IS_HANDLE_BOX (ancestor)))
+        result |= EQX_ROLE_TOOLBAR_ITEM;
+      if (EQUINOX_IS_PANEL_WIDGET (ancestor))
+        result |= EQX_ROLE_PANEL_ITEM;
+      if (EQUINOX_IS_COMBO (ancestor))
+        result |= EQX_ROLE_IN_COMBO;
+      if (EQUINOX_IS_COMBO_BOX (ancestor))
+        result |= EQX_ROLE_IN_COMBO_BOX;
+      if (EQUINOX_IS_COMBO_BOX_ENTRY (ancestor))
+        result |= EQX_ROLE_IN_COMBO_BOX_ENTRY;
+    }
+
+  if (parent && (EQUINOX_IS_TREE_VIEW (parent) || EQUINOX_IS_CLIST (parent) ||
+                 equinox_object_is_type (G_OBJECT (parent), EQX_GTYPE_ETREE) ||
+                 equinox_object_is_type (G_OBJECT (parent), EQX_GTYPE_ETABLE)))
+    result |= EQX_ROLE_TREE_HEADER;
+
+  if (grandparent)
+    {
+      if (EQUINOX_IS_COLOR_BUTTON (grandparent))
+        result |= EQX_ROLE_COLOR_SWATCH;
+      if (EQUINOX_IS_PANEL_WIDGET (grandparent))
+        result |= EQX_ROLE_PANEL_BUTTON;
+      if (grandparent->parent && EQUINOX_IS_COMBO_BOX (grandparent->parent))
+        {
+          if (!EQUINOX_IS_COMBO_BOX_ENTRY (grandparent->parent))
+            result |= EQX_ROLE_COMBO_BOX_BUTTON;
+          if (EQUINOX_IS_HBOX (parent) && EQUINOX_IS_TOGGLE_BUTTON (grandparent))
+            result |= EQX_ROLE_COMBO_BOX_SEPARATOR;
+        }
+    }
+
+  roles->roles = result;
+  roles->button_parent = equinox_find_button_parent (widget);
+  roles->valid = TRUE;
+}
+
+const EquinoxWidgetRoles *
+equinox_widget_get_roles (GtkWidget * widget)
+{
+  EquinoxWidgetRoles *roles;
+
+  if (!widget)
+    return &no_roles;
+
+  if (G_UNLIKELY (!equinox_roles_quark))
+    equinox_roles_quark = g_quark_from_static_string ("equinox-widget-roles");
+
+  roles = g_object_get_qdata (G_OBJECT (widget), equinox_roles_quark);
+  if (!roles)
+    {
+      roles = g_new0 (EquinoxWidgetRoles, 1);
+      g_object_set_qdata_full (G_OBJECT (widget), equinox_roles_quark, roles, g_free);
+
+      g_signal_connect (widget, "hierarchy-changed", G_CALLBACK (equinox_widget_roles_invalidate), roles);
+      g_signal_connect (widget, "parent-set", G_CALLBACK (equinox_widget_roles_invalidate), roles);
+    }
+
+  if (!roles->valid)
+    equinox_widget_roles_compute (widget, roles);
+
+  return roles;
+}
+
+/* Cached equivalent of equinox_is_in_combo_box */
+gboolean
+equinox_widget_in_combo_box (GtkWidget * widget)
+{
+  guint32 roles = equinox_widget_get_roles (widget)->roles;
+
+  if (roles & (EQX_ROLE_IN_COMBO | EQX_ROLE_IN_COMBO_BOX_ENTRY))
+    return TRUE;
+
+  /* "appears-as-list" is a style property and may change at any time */
+  return (roles & EQX_ROLE_IN_COMBO_BOX) && equinox_is_combo_box (widget, TRUE);
+}
+
 static GtkWidget *
 equinox_find_combo_box_entry_widget (GtkWidget * widget)
 {
@@ -788,16 +1011,50 @@ equinox_gdk_color_to_rgb (GdkColor *c, double *r, double *g, double *b)
 	*b = (double)c->blue  /  (double)65535;
 }
 
-void
-equinox_get_parent_bg (const GtkWidget *widget, EquinoxRGB *color)
+/* Parent background
+
+   Finding the background a widget is drawn on means walking up to the first
+   windowed (or framed) ancestor.  The result is kept in qdata per widget and
+   reused as long as that ancestor keeps its style, state and frame shadow;
+   the widget's own style-set, state-changed and reparenting throw it away.
+*/
+typedef struct {
+	gboolean         valid;
+	const GtkWidget *parent;	/* NULL: no background found */
+	GtkStyle        *parent_style;
+	GtkStateType     parent_state;
+	gboolean         parent_is_frame;
+	GtkShadowType    parent_shadow;
+	EquinoxRGB       color;
+} EquinoxParentBg;
+
+static GQuark equinox_parent_bg_quark = 0;
+static EquinoxParentBgStats parent_bg_stats;
+
+static void
+equinox_parent_bg_invalidate (GtkWidget * widget, gpointer unused, EquinoxParentBg * cache)
+{
+	if (cache->valid)
+		parent_bg_stats.invalidations++;
+	cache->valid = FALSE;
+}
+
+static void
+equinox_parent_bg_state_changed (GtkWidget * widget, GtkStateType previous_state, EquinoxParentBg * cache)
+{
+	equinox_parent_bg_invalidate (widget, NULL, cache);
+}
+
+static void
+equinox_parent_bg_resolve (const GtkWidget *widget, EquinoxParentBg *cache)
 {
 	GtkStateType state_type;
 	const GtkWidget *parent;
 	GdkColor *gcolor;
+	EquinoxRGB *color = &cache->color;
 
-	if (widget == NULL)
-		return;
-
+	cache->valid = TRUE;
+	cache->parent = NULL;
 
 	parent = widget->parent;
 
@@ -818,12 +1075,18 @@ equinox_get_parent_bg (const GtkWidget *widget, EquinoxRGB *color)
 
 	state_type = GTK_WIDGET_STATE (parent);
 
+	cache->parent = parent;
+	cache->parent_style = parent->style;
+	cache->parent_state = state_type;
+	cache->parent_is_frame = GTK_IS_FRAME (parent);
+
 	gcolor = &parent->style->bg[state_type];
 
 	equinox_gdk_color_to_rgb (gcolor, &color->r, &color->g, &color->b);
 
-    if (GTK_IS_FRAME (parent)) {
+    if (cache->parent_is_frame) {
     GtkShadowType shadow = gtk_frame_get_shadow_type(GTK_FRAME(parent));
+         cache->parent_shadow = shadow;
          if (shadow == (GTK_SHADOW_IN || GTK_SHADOW_ETCHED_IN))
          	equinox_shade (color, color, 0.97);
          else if (shadow == (GTK_SHADOW_OUT || GTK_SHADOW_ETCHED_OUT))
@@ -831,6 +1094,226 @@ equinox_get_parent_bg (const GtkWidget *widget, EquinoxRGB *color)
     }
 }
 
+static gboolean
+equinox_parent_bg_is_current (const EquinoxParentBg *cache)
+{
+	const GtkWidget *parent = cache->parent;
+
+	if (!cache->valid)
+		return FALSE;
+	if (parent == NULL)
+		return TRUE;
+
+	return parent->style == cache->parent_style &&
+	       GTK_WIDGET_STATE (parent) == cache->parent_state &&
+	       (!cache->parent_is_frame || gtk_frame_get_shadow_type (GTK_FRAME (parent)) == cache->parent_shadow);
+}
+
+void
+equinox_get_parent_bg (const GtkWidget *widget, EquinoxRGB *color)
+{
+	EquinoxParentBg *cache;
+
+	if (widget == NULL)
+		return;
+
+	if (G_UNLIKELY (!equinox_parent_bg_quark))
+		equinox_parent_bg_quark = g_quark_from_static_string ("equinox-parent-bg");
+
+	cache = g_object_get_qdata (G_OBJECT (widget), equinox_parent_bg_quark);
+	if (!cache) {
+		cache = g_new0 (EquinoxParentBg, 1);
+		g_object_set_qdata_full (G_OBJECT (widget), equinox_parent_bg_quark, cache, g_free);
+
+		g_signal_connect ((GtkWidget*) widget, "style-set", G_CALLBACK (equinox_parent_bg_invalidate), cache);
+		g_signal_connect ((GtkWidget*) widget, "state-changed", G_CALLBACK (equinox_parent_bg_state_changed), cache);
+		g_signal_connect ((GtkWidget*) widget, "parent-set", G_CALLBACK (equinox_parent_bg_invalidate), cache);
+		g_signal_connect ((GtkWidget*) widget, "hierarchy-changed", G_CALLBACK (equinox_parent_bg_invalidate), cache);
+	}
+
+	if (equinox_parent_bg_is_current (cache)) {
+		parent_bg_stats.hits++;
+	} else {
+		parent_bg_stats.misses++;
+		equinox_parent_bg_resolve (widget, cache);
+	}
+
+	if (cache->parent)
+		*color = cache->color;
+}
+
+void
+equinox_parent_bg_get_stats (EquinoxParentBgStats *stats)
+{
+	*stats = parent_bg_stats;
+}
+
+void
+equinox_parent_bg_print_stats (void)
+{
+	gulong lookups = parent_bg_stats.hits + parent_bg_stats.misses;
+
+	g_printerr ("equinox: parent bg: %lu hits, %lu misses (%.1f%% hit rate), %lu invalidated\n",
+	            parent_bg_stats.hits, parent_bg_stats.misses,
+	            lookups ? 100.0 * parent_bg_stats.hits / lookups : 0.0,
+	            parent_bg_stats.invalidations);
+}
+
+/* Lazy widget parameters
+
+   equinox_set_widget_parameters only fills in what is cheap to know.  The
+   parent background and text direction are looked up the first time a draw
+   function asks for them and kept in the EquinoxLazyParams the parameter
+   block points to, which is shared with the frame memo copy.  The counters show, per style entry point, how often the
+   lookups are actually needed.
+*/
+typedef struct {
+	gulong setups;
+	gulong parentbg;
+	gulong ltr;
+} EquinoxParamsStats;
+
+static EquinoxParamsStats params_stats[EQX_ENTRY_LAST];
+
+void
+equinox_params_count_setup (void)
+{
+	params_stats[equinox_detail_current_entry ()].setups++;
+}
+
+const EquinoxRGB *
+equinox_params_parentbg (const WidgetParameters *params)
+{
+	EquinoxLazyParams *lazy = params->lazy;
+
+	if (lazy->pending & EQX_PARAM_PARENTBG) {
+		lazy->pending &= ~EQX_PARAM_PARENTBG;
+		if (lazy->source)
+			equinox_get_parent_bg (lazy->source, &lazy->parentbg);
+		params_stats[equinox_detail_current_entry ()].parentbg++;
+	}
+
+	return &lazy->parentbg;
+}
+
+boolean
+equinox_params_ltr (const WidgetParameters *params)
+{
+	EquinoxLazyParams *lazy = params->lazy;
+
+	if (lazy->pending & EQX_PARAM_LTR) {
+		lazy->pending &= ~EQX_PARAM_LTR;
+		lazy->ltr = equinox_widget_is_ltr ((GtkWidget *) lazy->source);
+		params_stats[equinox_detail_current_entry ()].ltr++;
+	}
+
+	return lazy->ltr;
+}
+
+void
+equinox_params_print_stats (void)
+{
+	guint entry;
+
+	for (entry = 0; entry < EQX_ENTRY_LAST; entry++) {
+		EquinoxParamsStats *stats = &params_stats[entry];
+
+		if (stats->setups == 0)
+			continue;
+
+		g_printerr ("equinox: draw_%s: %lu parameter setups, parent bg needed %lu (%.1f%%), direction needed %lu (%.1f%%)\n",
+		            equinox_detail_entry_name (entry), stats->setups,
+		            stats->parentbg, 100.0 * stats->parentbg / stats->setups,
+		            stats->ltr, 100.0 * stats->ltr / stats->setups);
+	}
+}
+
+/* Area culling
+
+   The style clips every draw call to the exposed area, so the clip extents
+   are the expose rectangle in the primitive's own coordinates.  The
+   drawing helpers test each layer against them before building its path:
+   a layer entirely outside the area is skipped, and so is an outline when
+   the area lies inside it without touching the line (a caret blinking in
+   an entry, a row in the middle of a tree view).  A culled layer drops the
+   current path, just like its fill or stroke would have.
+*/
+typedef struct {
+	gulong layers;
+	gulong outside;
+	gulong inside;
+} EquinoxCullStats;
+
+static EquinoxCullStats cull_stats[EQX_ENTRY_LAST];
+
+/* one extra pixel for antialiasing */
+#define CULL_MARGIN 1.0
+
+boolean
+equinox_cull_box (cairo_t *cr, double x, double y, double width, double height)
+{
+	EquinoxCullStats *stats = &cull_stats[equinox_detail_current_entry ()];
+	double x1, y1, x2, y2;
+
+	stats->layers++;
+	cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+
+	if (x2 <= x - CULL_MARGIN || x1 >= x + width + CULL_MARGIN ||
+	    y2 <= y - CULL_MARGIN || y1 >= y + height + CULL_MARGIN) {
+		stats->outside++;
+		cairo_new_path (cr);
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+boolean
+equinox_cull_outline (cairo_t *cr, double x, double y, double width, double height, double radius)
+{
+	EquinoxCullStats *stats = &cull_stats[equinox_detail_current_entry ()];
+	double x1, y1, x2, y2;
+	double outer = cairo_get_line_width (cr) / 2.0 + CULL_MARGIN;
+	double inner = outer + MAX (radius, 0);
+
+	stats->layers++;
+	cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+
+	if (x2 <= x - outer || x1 >= x + width + outer ||
+	    y2 <= y - outer || y1 >= y + height + outer) {
+		stats->outside++;
+		cairo_new_path (cr);
+		return TRUE;
+	}
+
+	/* rounded corners only ever bend inwards, by less than the radius */
+	if (x1 >= x + inner && x2 <= x + width - inner &&
+	    y1 >= y + inner && y2 <= y + height - inner) {
+		stats->inside++;
+		cairo_new_path (cr);
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+void
+equinox_cull_print_stats (void)
+{
+	guint entry;
+
+	for (entry = 0; entry < EQX_ENTRY_LAST; entry++) {
+		EquinoxCullStats *stats = &cull_stats[entry];
+
+		if (stats->layers == 0)
+			continue;
+
+		g_printerr ("equinox: draw_%s: %lu layers, culled %lu outside the area, %lu around it (%.1f%%)\n",
+		            equinox_detail_entry_name (entry), stats->layers, stats->outside, stats->inside,
+		            100.0 * (stats->outside + stats->inside) / stats->layers);
+	}
+}
+
 void  equinox_set_source_rgb (cairo_t *cr, const EquinoxRGB *color) {
 	equinox_set_source_rgba (cr, color, 1.0);
 }
@@ -10,83 +10,168 @@
 #define RADIO_SIZE 15
 #define CHECK_SIZE 15
 
-
-#define EQUINOX_IS_WIDGET(object) ((object)  && equinox_object_is_a ((GObject*)(object), "GtkWidget"))
-#define EQUINOX_IS_CONTAINER(object) ((object)  && equinox_object_is_a ((GObject*)(object), "GtkContainer"))
-#define EQUINOX_IS_BIN(object) ((object)  && equinox_object_is_a ((GObject*)(object), "GtkBin"))
-
-#define EQUINOX_IS_ARROW(object) ((object)  && equinox_object_is_a ((GObject*)(object), "GtkArrow"))
-
-#define EQUINOX_IS_SEPARATOR(object) ((object)  && equinox_object_is_a ((GObject*)(object), "GtkSeparator"))
-#define EQUINOX_IS_VSEPARATOR(object) ((object)  && equinox_object_is_a ((GObject*)(object), "GtkVSeparator"))
-#define EQUINOX_IS_HSEPARATOR(object) ((object)  && equinox_object_is_a ((GObject*)(object), "GtkHSeparator"))
-
-#define EQUINOX_IS_HANDLE_BOX(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkHandleBox"))
+/* Types checked by the EQUINOX_IS_* macros, resolved once by name */
+typedef enum {
+	EQX_GTYPE_WIDGET,
+	EQX_GTYPE_CONTAINER,
+	EQX_GTYPE_BIN,
+	EQX_GTYPE_ARROW,
+	EQX_GTYPE_SEPARATOR,
+	EQX_GTYPE_VSEPARATOR,
+	EQX_GTYPE_HSEPARATOR,
+	EQX_GTYPE_HANDLE_BOX,
+	EQX_GTYPE_BONOBO_DOCK_ITEM,
+	EQX_GTYPE_BONOBO_DOCK_ITEM_GRIP,
+	EQX_GTYPE_BONOBO_UI_TOOLBAR,
+	EQX_GTYPE_EGG_TOOLBAR,
+	EQX_GTYPE_TOOLBAR,
+	EQX_GTYPE_PANEL_WIDGET,
+	EQX_GTYPE_PANEL_APPLET,
+	EQX_GTYPE_WINDOW,
+	EQX_GTYPE_COMBO_BOX_ENTRY,
+	EQX_GTYPE_COMBO_BOX,
+	EQX_GTYPE_COMBO,
+	EQX_GTYPE_OPTION_MENU,
+	EQX_GTYPE_TOGGLE_BUTTON,
+	EQX_GTYPE_CHECK_BUTTON,
+	EQX_GTYPE_RADIO_BUTTON,
+	EQX_GTYPE_SPIN_BUTTON,
+	EQX_GTYPE_STATUSBAR,
+	EQX_GTYPE_PROGRESS_BAR,
+	EQX_GTYPE_MENU_SHELL,
+	EQX_GTYPE_MENU,
+	EQX_GTYPE_MENU_BAR,
+	EQX_GTYPE_MENU_ITEM,
+	EQX_GTYPE_CHECK_MENU_ITEM,
+	EQX_GTYPE_RANGE,
+	EQX_GTYPE_SCROLLBAR,
+	EQX_GTYPE_VSCROLLBAR,
+	EQX_GTYPE_HSCROLLBAR,
+	EQX_GTYPE_SCALE,
+	EQX_GTYPE_VSCALE,
+	EQX_GTYPE_HSCALE,
+	EQX_GTYPE_PANED,
+	EQX_GTYPE_VPANED,
+	EQX_GTYPE_HPANED,
+	EQX_GTYPE_BOX,
+	EQX_GTYPE_VBOX,
+	EQX_GTYPE_HBOX,
+	EQX_GTYPE_CLIST,
+	EQX_GTYPE_TREE_VIEW,
+	EQX_GTYPE_ENTRY,
+	EQX_GTYPE_BUTTON,
+	EQX_GTYPE_FIXED,
+	EQX_GTYPE_VIEWPORT,
+	EQX_GTYPE_SCROLLED_WINDOW,
+	EQX_GTYPE_NOTEBOOK,
+	EQX_GTYPE_CELL_RENDERER_TOGGLE,
+	EQX_GTYPE_COLOR_BUTTON,
+	EQX_GTYPE_EVENT_BOX,
+	EQX_GTYPE_ETREE,
+	EQX_GTYPE_ETABLE,
+	EQX_GTYPE_LAST
+} EquinoxTypeId;
+
+
+#define EQUINOX_IS_WIDGET(object) ((object)  && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_WIDGET))
+#define EQUINOX_IS_CONTAINER(object) ((object)  && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_CONTAINER))
+#define EQUINOX_IS_BIN(object) ((object)  && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_BIN))
+
+#define EQUINOX_IS_ARROW(object) ((object)  && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_ARROW))
+
+#define EQUINOX_IS_SEPARATOR(object) ((object)  && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_SEPARATOR))
+#define EQUINOX_IS_VSEPARATOR(object) ((object)  && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_VSEPARATOR))
+#define EQUINOX_IS_HSEPARATOR(object) ((object)  && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_HSEPARATOR))
+
+#define EQUINOX_IS_HANDLE_BOX(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_HANDLE_BOX))
 #define EQUINOX_IS_HANDLE_BOX_ITEM(object) ((object) && EQUINOX_IS_HANDLE_BOX(object->parent))
-#define EQUINOX_IS_BONOBO_DOCK_ITEM(object) ((object) && equinox_object_is_a ((GObject*)(object), "BonoboDockItem"))
-#define EQUINOX_IS_BONOBO_DOCK_ITEM_GRIP(object) ((object) && equinox_object_is_a ((GObject*)(object), "BonoboDockItemGrip"))
-#define EQUINOX_IS_BONOBO_TOOLBAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "BonoboUIToolbar"))
-#define EQUINOX_IS_EGG_TOOLBAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "Toolbar"))
-#define EQUINOX_IS_TOOLBAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkToolbar"))
-#define EQUINOX_IS_PANEL_WIDGET(object) ((object) && (equinox_object_is_a ((GObject*)(object), "PanelWidget") || equinox_object_is_a ((GObject*)(object), "PanelApplet")))
-#define EQUINOX_IS_WINDOW(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkWindow"))
+#define EQUINOX_IS_BONOBO_DOCK_ITEM(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_BONOBO_DOCK_ITEM))
+#define EQUINOX_IS_BONOBO_DOCK_ITEM_GRIP(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_BONOBO_DOCK_ITEM_GRIP))
+#define EQUINOX_IS_BONOBO_TOOLBAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_BONOBO_UI_TOOLBAR))
+#define EQUINOX_IS_EGG_TOOLBAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_EGG_TOOLBAR))
+#define EQUINOX_IS_TOOLBAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_TOOLBAR))
+#define EQUINOX_IS_PANEL_WIDGET(object) ((object) && (equinox_object_is_type ((GObject*)(object), EQX_GTYPE_PANEL_WIDGET) || equinox_object_is_type ((GObject*)(object), EQX_GTYPE_PANEL_APPLET)))
+#define EQUINOX_IS_WINDOW(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_WINDOW))
 
 
-#define EQUINOX_IS_COMBO_BOX_ENTRY(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkComboBoxEntry"))
-#define EQUINOX_IS_COMBO_BOX(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkComboBox"))
-#define EQUINOX_IS_COMBO(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkCombo"))
-#define EQUINOX_IS_OPTION_MENU(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkOptionMenu"))
+#define EQUINOX_IS_COMBO_BOX_ENTRY(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_COMBO_BOX_ENTRY))
+#define EQUINOX_IS_COMBO_BOX(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_COMBO_BOX))
+#define EQUINOX_IS_COMBO(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_COMBO))
+#define EQUINOX_IS_OPTION_MENU(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_OPTION_MENU))
 
-#define EQUINOX_IS_TOGGLE_BUTTON(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkToggleButton"))
-#define EQUINOX_IS_CHECK_BUTTON(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkCheckButton"))
-#define EQUINOX_IS_RADIO_BUTTON(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkRadioButton"))
-#define EQUINOX_IS_SPIN_BUTTON(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkSpinButton"))
+#define EQUINOX_IS_TOGGLE_BUTTON(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_TOGGLE_BUTTON))
+#define EQUINOX_IS_CHECK_BUTTON(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_CHECK_BUTTON))
+#define EQUINOX_IS_RADIO_BUTTON(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_RADIO_BUTTON))
+#define EQUINOX_IS_SPIN_BUTTON(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_SPIN_BUTTON))
 
-#define EQUINOX_IS_STATUSBAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkStatusbar"))
-#define EQUINOX_IS_PROGRESS_BAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkProgressBar"))
+#define EQUINOX_IS_STATUSBAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_STATUSBAR))
+#define EQUINOX_IS_PROGRESS_BAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_PROGRESS_BAR))
 
-#define EQUINOX_IS_MENU_SHELL(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkMenuShell"))
-#define EQUINOX_IS_MENU(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkMenu"))
-#define EQUINOX_IS_MENU_BAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkMenuBar"))
-#define EQUINOX_IS_MENU_ITEM(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkMenuItem"))
+#define EQUINOX_IS_MENU_SHELL(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_MENU_SHELL))
+#define EQUINOX_IS_MENU(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_MENU))
+#define EQUINOX_IS_MENU_BAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_MENU_BAR))
+#define EQUINOX_IS_MENU_ITEM(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_MENU_ITEM))
 
-#define EQUINOX_IS_CHECK_MENU_ITEM(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkCheckMenuItem"))
+#define EQUINOX_IS_CHECK_MENU_ITEM(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_CHECK_MENU_ITEM))
 
-#define EQUINOX_IS_RANGE(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkRange"))
+#define EQUINOX_IS_RANGE(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_RANGE))
 
-#define EQUINOX_IS_SCROLLBAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkScrollbar"))
-#define EQUINOX_IS_VSCROLLBAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkVScrollbar"))
-#define EQUINOX_IS_HSCROLLBAR(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkHScrollbar"))
+#define EQUINOX_IS_SCROLLBAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_SCROLLBAR))
+#define EQUINOX_IS_VSCROLLBAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_VSCROLLBAR))
+#define EQUINOX_IS_HSCROLLBAR(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_HSCROLLBAR))
 
-#define EQUINOX_IS_SCALE(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkScale"))
-#define EQUINOX_IS_VSCALE(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkVScale"))
-#define EQUINOX_IS_HSCALE(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkHScale"))
+#define EQUINOX_IS_SCALE(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_SCALE))
+#define EQUINOX_IS_VSCALE(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_VSCALE))
+#define EQUINOX_IS_HSCALE(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_HSCALE))
 
-#define EQUINOX_IS_PANED(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkPaned"))
-#define EQUINOX_IS_VPANED(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkVPaned"))
-#define EQUINOX_IS_HPANED(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkHPaned"))
+#define EQUINOX_IS_PANED(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_PANED))
+#define EQUINOX_IS_VPANED(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_VPANED))
+#define EQUINOX_IS_HPANED(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_HPANED))
 
-#define EQUINOX_IS_BOX(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkBox"))
-#define EQUINOX_IS_VBOX(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkVBox"))
-#define EQUINOX_IS_HBOX(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkHBox"))
+#define EQUINOX_IS_BOX(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_BOX))
+#define EQUINOX_IS_VBOX(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_VBOX))
+#define EQUINOX_IS_HBOX(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_HBOX))
 
-#define EQUINOX_IS_CLIST(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkCList"))
-#define EQUINOX_IS_TREE_VIEW(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkTreeView"))
-#define EQUINOX_IS_ENTRY(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkEntry"))
-#define EQUINOX_IS_BUTTON(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkButton"))
-#define EQUINOX_IS_FIXED(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkFixed"))
-#define EQUINOX_IS_VIEWPORT(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkViewport"))
-#define EQUINOX_IS_SCROLLED_WINDOW(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkScrolledWindow"))
+#define EQUINOX_IS_CLIST(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_CLIST))
+#define EQUINOX_IS_TREE_VIEW(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_TREE_VIEW))
+#define EQUINOX_IS_ENTRY(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_ENTRY))
+#define EQUINOX_IS_BUTTON(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_BUTTON))
+#define EQUINOX_IS_FIXED(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_FIXED))
+#define EQUINOX_IS_VIEWPORT(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_VIEWPORT))
+#define EQUINOX_IS_SCROLLED_WINDOW(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_SCROLLED_WINDOW))
 
 #define TOGGLE_BUTTON(object) (EQUINOX_IS_TOGGLE_BUTTON(object)?(GtkToggleButton *)object:NULL)
 
-#define EQUINOX_IS_NOTEBOOK(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkNotebook"))
-#define EQUINOX_IS_CELL_RENDERER_TOGGLE(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkCellRendererToggle"))
+#define EQUINOX_IS_NOTEBOOK(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_NOTEBOOK))
+#define EQUINOX_IS_CELL_RENDERER_TOGGLE(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_CELL_RENDERER_TOGGLE))
 
 #define EQUINOX_WIDGET_HAS_DEFAULT(object) ((object) && EQUINOX_IS_WIDGET(object) && GTK_WIDGET_HAS_DEFAULT(object))
 
-#define EQUINOX_IS_COLOR_BUTTON(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkColorButton"))
-#define EQUINOX_IS_EVENT_BOX(object) ((object) && equinox_object_is_a ((GObject*)(object), "GtkEventBox"))
+#define EQUINOX_IS_COLOR_BUTTON(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_COLOR_BUTTON))
+#define EQUINOX_IS_EVENT_BOX(object) ((object) && equinox_object_is_type ((GObject*)(object), EQX_GTYPE_EVENT_BOX))
+
+/* What a widget is used as, worked out from its ancestors.  Cached per
+ * widget by equinox_widget_get_roles until its hierarchy changes. */
+typedef enum {
+	EQX_ROLE_TOOLBAR_ITEM      = 1 << 0,	/* inside a toolbar, dock item or handle box */
+	EQX_ROLE_PANEL_ITEM        = 1 << 1,	/* inside a panel */
+	EQX_ROLE_IN_COMBO          = 1 << 2,	/* inside a GtkCombo */
+	EQX_ROLE_IN_COMBO_BOX      = 1 << 3,	/* inside a GtkComboBox, list mode not checked */
+	EQX_ROLE_IN_COMBO_BOX_ENTRY = 1 << 4,	/* inside a GtkComboBoxEntry */
+	EQX_ROLE_TREE_HEADER       = 1 << 5,	/* parent is a tree view, clist, ETree or ETable */
+	EQX_ROLE_COLOR_SWATCH      = 1 << 6,	/* grandparent is a GtkColorButton */
+	EQX_ROLE_PANEL_BUTTON      = 1 << 7,	/* grandparent is a panel widget */
+	EQX_ROLE_COMBO_BOX_BUTTON  = 1 << 8,	/* great-grandparent is a non-entry GtkComboBox */
+	EQX_ROLE_COMBO_BOX_SEPARATOR = 1 << 9	/* hbox in the toggle button of a GtkComboBox */
+} EquinoxWidgetRole;
+
+typedef struct {
+	gboolean   valid;
+	guint32    roles;
+	GtkWidget *button_parent;	/* nearest button-like ancestor, for draw_layout */
+} EquinoxWidgetRoles;
+
+#define EQUINOX_WIDGET_HAS_ROLE(widget, role) ((widget) && (equinox_widget_get_roles ((GtkWidget*)(widget))->roles & (role)))
 
 
 
@@ -139,6 +224,26 @@ G_GNUC_INTERNAL void  equinox_gtk_clist_get_header_index    (GtkCList     *clist
 G_GNUC_INTERNAL void  equinox_get_parent_bg      (const GtkWidget *widget,
                                                  EquinoxRGB      *color);
 
+typedef struct {
+	gulong hits;
+	gulong misses;
+	gulong invalidations;
+} EquinoxParentBgStats;
+
+G_GNUC_INTERNAL void  equinox_parent_bg_get_stats   (EquinoxParentBgStats *stats);
+G_GNUC_INTERNAL void  equinox_parent_bg_print_stats (void);
+
+G_GNUC_INTERNAL const EquinoxRGB *equinox_params_parentbg (const WidgetParameters *params);
+G_GNUC_INTERNAL boolean           equinox_params_ltr      (const WidgetParameters *params);
+G_GNUC_INTERNAL void              equinox_params_count_setup (void);
+G_GNUC_INTERNAL void              equinox_params_print_stats (void);
+
+/* TRUE if a layer with these bounds is outside the area being drawn; the
+ * outline variant is also TRUE if the area is inside a stroked outline */
+G_GNUC_INTERNAL boolean           equinox_cull_box        (cairo_t *cr, double x, double y, double width, double height);
+G_GNUC_INTERNAL boolean           equinox_cull_outline    (cairo_t *cr, double x, double y, double width, double height, double radius);
+G_GNUC_INTERNAL void              equinox_cull_print_stats (void);
+
 G_GNUC_INTERNAL void  equinox_option_menu_get_props         (GtkWidget       *widget,
                                                  GtkRequisition  *indicator_size,
                                                  GtkBorder       *indicator_spacing);
@@ -146,7 +251,8 @@ G_GNUC_INTERNAL void  equinox_option_menu_get_props         (GtkWidget       *wi
 G_GNUC_INTERNAL gboolean          mrn_is_panel_widget            (GtkWidget *widget);
 
 
-G_GNUC_INTERNAL gboolean  equinox_object_is_a (const GObject * object, const gchar * type_name);
+G_GNUC_INTERNAL gboolean  equinox_object_is_type (const GObject * object, EquinoxTypeId type_id);
+G_GNUC_INTERNAL void      equinox_types_rescan (void);
 G_GNUC_INTERNAL gboolean  equinox_is_combo_box_entry (GtkWidget * widget);
 G_GNUC_INTERNAL gboolean  equinox_is_combo_box (GtkWidget * widget, gboolean as_list);
 G_GNUC_INTERNAL gboolean equinox_is_tree_column_header (GtkWidget * widget);
@@ -155,6 +261,8 @@ G_GNUC_INTERNAL gboolean  equinox_is_in_combo_box (GtkWidget * widget);
 G_GNUC_INTERNAL gboolean  equinox_is_toolbar_item (GtkWidget * widget);
 G_GNUC_INTERNAL gboolean  equinox_is_panel_widget_item (GtkWidget * widget);
 G_GNUC_INTERNAL gboolean  equinox_is_bonobo_dock_item (GtkWidget * widget);
+G_GNUC_INTERNAL const EquinoxWidgetRoles *equinox_widget_get_roles (GtkWidget * widget);
+G_GNUC_INTERNAL gboolean  equinox_widget_in_combo_box (GtkWidget * widget);
 G_GNUC_INTERNAL GtkWidget* equinox_find_combo_box_widget_parent (GtkWidget * widget);
 G_GNUC_INTERNAL gboolean  equinox_widget_is_ltr (GtkWidget *widget);
 